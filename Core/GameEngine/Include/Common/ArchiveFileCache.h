@@ -0,0 +1,66 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ArchiveFileCache.h
+// Cache file of the directories of all archive files, to skip reading them at startup
+
+#pragma once
+
+#include "Common/ArchiveFileSystem.h"
+
+/**
+ * Keeps the directories of the archive files in a single cache file, keyed by the path, size
+ * and modification time of each archive file. An archive file that has not changed since the
+ * cache was written gets its directory from the cache instead of reading it from the archive.
+ *
+ * Enable it with -archiveCache. The cache is written again after loading if any archive file
+ * was added, removed or changed.
+ */
+class ArchiveFileCache
+{
+public:
+
+	ArchiveFileCache();
+	~ArchiveFileCache();
+
+	Bool read( const Char *filename );			///< Load the cache file, return false if it is missing or invalid
+	Bool write( const Char *filename, const ArchiveFileMap &archiveFiles ) const;	///< Write the directories of the given archive files
+	void clear( void );
+
+	/// Add the files of an unchanged archive file from the cache, return false if the archive file is not
+	/// in the cache or has changed. Can be called by several threads at once.
+	Bool fillArchiveFile( const Char *archiveFilename, ArchiveFile *archiveFile ) const;
+
+	/// True if every given archive file came from the cache and the cache has no others.
+	Bool isUpToDate( const ArchiveFileMap &archiveFiles ) const;
+
+private:
+
+	struct CachedArchive
+	{
+		FileInfo fileInfo;
+		const char *records;		///< Points into m_data
+		const char *recordsEnd;
+	};
+
+	typedef std::map<AsciiString, CachedArchive> CachedArchiveMap;
+
+	char *m_data;										///< The whole cache file
+	CachedArchiveMap m_archives;		///< Keyed by the archive filename in lower case
+	mutable volatile LONG m_filledCount;
+};
@@ -63,6 +63,7 @@
 
 class File;
 class ArchiveFile;
+class ArchiveFileCache;
 
 //----------------------------------------------------------------------------
 //           Type Defines
@@ -80,31 +81,12 @@ class ArchiveFile;
 	* openFile() member searches all Archive files for the specified sub file.
 	*/
 //===============================
-class ArchivedDirectoryInfo;
 class DetailedArchivedDirectoryInfo;
 class ArchivedFileInfo;
 
 typedef std::map<AsciiString, DetailedArchivedDirectoryInfo> DetailedArchivedDirectoryInfoMap;
-typedef std::map<AsciiString, ArchivedDirectoryInfo> ArchivedDirectoryInfoMap;
 typedef std::map<AsciiString, ArchivedFileInfo> ArchivedFileInfoMap;
 typedef std::map<AsciiString, ArchiveFile *> ArchiveFileMap;
-typedef std::map<AsciiString, AsciiString> ArchivedFileLocationMap; // first string is the file name, second one is the archive filename.
-
-class ArchivedDirectoryInfo
-{
-public:
-	AsciiString								m_directoryName;
-	ArchivedDirectoryInfoMap	m_directories;
-	ArchivedFileLocationMap		m_files;
-
-	void clear()
-	{
-		m_directoryName.clear();
-		m_directories.clear();
-		m_files.clear();
-	}
-
-};
 
 class DetailedArchivedDirectoryInfo
 {
@@ -144,6 +126,44 @@ public:
 };
 
 
+//===============================
+// ArchivedFileIndex
+//===============================
+/**
+	* Open addressed hash table of every file in the mounted archive files, keyed by the full
+	* path in lower case with backslashes. A lookup costs one hash of the path and usually one
+	* probe, instead of a map lookup per directory level.
+	*/
+//===============================
+class ArchivedFileIndex
+{
+public:
+	struct Entry
+	{
+		Entry() : m_hash(0), m_archiveFile(NULL), m_fileInfo(NULL) {}
+
+		UnsignedInt								m_hash;
+		AsciiString								m_path;							///< Normalized full path, empty for unused slots
+		ArchiveFile								*m_archiveFile;			///< NULL once the archive file is closed
+		const ArchivedFileInfo		*m_fileInfo;				///< Owned by m_archiveFile
+		AsciiString								m_archiveFilename;
+	};
+
+	ArchivedFileIndex() : m_count(0) {}
+
+	void clear( void );
+	void addFile( const AsciiString& path, ArchiveFile *archiveFile, const ArchivedFileInfo *fileInfo, const AsciiString& archiveFilename, Bool overwrite );
+	void removeArchiveFile( const ArchiveFile *archiveFile );	///< Forget the files of an archive file that is about to be closed
+	const Entry *findFile( const Char *path ) const;					///< Returns NULL if no open archive file has this file
+
+private:
+	Int findSlot( const Char *normalizedPath, UnsignedInt hash ) const;
+	void grow( void );
+
+	std::vector<Entry> m_entries;	///< Size is a power of two and at least twice the count
+	Int m_count;
+};
+
 class ArchiveFileSystem : public SubsystemInterface
 {
 	public:
@@ -175,10 +195,15 @@ class ArchiveFileSystem : public SubsystemInterface
 	void loadMods( void );
 
 protected:
-	virtual void					loadIntoDirectoryTree(const ArchiveFile *archiveFile, const AsciiString& archiveFilename, Bool overwrite = FALSE );	///< load the archive file's header information and apply it to the global archive directory tree.
+	void									readArchiveCache( void );		///< read the archive cache file given by -archiveCache, if any
+	void									writeArchiveCache( void );	///< write the archive cache file if it is out of date, and drop the cache
+	Bool									fillArchiveFileFromCache(const Char *filename, ArchiveFile *archiveFile) const;	///< add the files of an unchanged archive file from the archive cache. thread safe.
+	void									openArchiveFiles(const FilenameList &filenameList, std::vector<ArchiveFile *> &archiveFiles);	///< open the archive files of the list in parallel, results are in the order of the list.
+	virtual void					loadIntoDirectoryTree(ArchiveFile *archiveFile, const AsciiString& archiveFilename, Bool overwrite = FALSE );	///< load the archive file's header information and apply it to the global archive file index.
 
 	ArchiveFileMap m_archiveFileMap;
-	ArchivedDirectoryInfo m_rootDirectory;
+	ArchivedFileIndex m_fileIndex;
+	ArchiveFileCache *m_archiveCache;	///< only exists while the archive files are loaded at startup
 };
 
 
@@ -62,6 +62,12 @@
 	#define MEMORYPOOL_DEBUG
 #endif
 
+// TheSuperHackers @performance Per-thread caches of free blocks in front of the memory pools.
+// The debug bookkeeping and checkpointing need to see every block, so they go without.
+#if !defined(MEMORYPOOL_DEBUG) && !defined(DISABLE_MEMORYPOOL_MAGAZINES)
+	#define MEMORYPOOL_MAGAZINES
+#endif
+
 // SYSTEM INCLUDES ////////////////////////////////////////////////////////////
 
 #include <new.h>
@@ -222,6 +228,7 @@
 
 class MemoryPoolSingleBlock;
 class MemoryPoolBlob;
+struct MemoryPoolMagazine;
 class MemoryPool;
 class MemoryPoolFactory;
 class DynamicMemoryAllocator;
@@ -308,7 +315,11 @@ private:
 	Int								m_peakUsedBlocksInPool;			///< high-water mark of m_usedBlocksInPool
 	MemoryPoolBlob		*m_firstBlob;								///< head of linked list: first blob for this pool.
 	MemoryPoolBlob		*m_lastBlob;								///< tail of linked list: last blob for this pool. (needed for efficiency)
-	MemoryPoolBlob		*m_firstBlobWithFreeBlocks;	///< first blob in this pool that has at least one unallocated block.
+	MemoryPoolBlob		*m_firstBlobWithFreeBlocks;	///< head of linked list: the blobs in this pool that have at least one unallocated block.
+#ifdef MEMORYPOOL_MAGAZINES
+	Int								m_magazineIndex;						///< slot of this pool in the per-thread magazine tables, or -1 if it has none
+	UnsignedInt				m_magazineEpoch;						///< incremented by reset(), so that the magazines drop the blocks of the old blobs
+#endif
 
 private:
 	/// create a new blob with the given number of blocks.
@@ -317,6 +328,18 @@ private:
 	/// destroy a blob.
 	Int freeBlob(MemoryPoolBlob *blob);
 
+	/// take a block from the blobs. (caller must hold TheMemoryPoolCriticalSection)
+	MemoryPoolSingleBlock* allocateSingleBlockFromBlobs(DECLARE_LITERALSTRING_ARG1);
+
+	/// give a block back to its blob. (caller must hold TheMemoryPoolCriticalSection)
+	void freeSingleBlockToBlobs(MemoryPoolSingleBlock *block);
+
+#ifdef MEMORYPOOL_MAGAZINES
+	MemoryPoolMagazine* getThreadMagazine();												///< the magazine of the calling thread, or null
+	void refillMagazine(MemoryPoolMagazine *magazine);						///< take a batch of blocks from the blobs
+	void drainMagazine(MemoryPoolMagazine *magazine, Int keepCount);	///< give blocks back until keepCount are left
+#endif
+
 public:
 
 	// 'public' funcs that are really only for use by MemoryPoolFactory
@@ -363,7 +386,7 @@ public:
 	/// return the number of free (available) blocks in this pool.
 	Int getFreeBlockCount();
 
-	/// return the number of blocks in use in this pool.
+	/// return the number of blocks in use in this pool. (includes the blocks cached by the thread magazines)
 	Int getUsedBlockCount();
 
 	/// return the total number of blocks in this pool. [ == getFreeBlockCount() + getUsedBlockCount() ]
@@ -375,6 +398,9 @@ public:
 	/// return the initial allocation count for this pool
 	Int getInitialBlockCount();
 
+	/// return the overflow allocation count for this pool (zero if it may not grow)
+	Int getOverflowBlockCount();
+
 	Int countBlobsInPool();
 
 	/// if this pool has any empty blobs, return them to the system.
@@ -383,6 +409,14 @@ public:
 	/// destroy all blocks and blobs in this pool.
 	void reset();
 
+	/// grow this pool so that it has at least the given number of blocks in total.
+	void reserveBlocks(Int count);
+
+	#ifdef MEMORYPOOL_MAGAZINES
+		/// give the free blocks cached by the calling thread back to the pool.
+		void drainThreadMagazine();
+	#endif
+
 	#ifdef MEMORYPOOL_DEBUG
 		/// return true iff this block was allocated by this pool.
 		Bool debugIsBlockInPool(void *pBlock);
@@ -536,6 +570,9 @@ public:
 	/// return the pool with the given name. if no such pool exists, return null.
 	MemoryPool *findMemoryPool(const char *poolName);
 
+	/// return the first pool of this factory; use MemoryPool::getNextPoolInList() for the others.
+	MemoryPool *getFirstMemoryPool() { return m_firstPoolInFactory; }
+
 	/// destroy the given pool.
 	void destroyMemoryPool(MemoryPool *pMemoryPool);
 
@@ -550,6 +587,12 @@ public:
 
 	void memoryPoolUsageReport( const char* filename, FILE *appendToFileInstead = NULL );
 
+	/// allocate and free lots of blocks in every pool, print the time taken per pool and return the process exit code.
+	Int memoryPoolBenchmark();
+
+	/// give the blocks that the calling thread caches back to all pools. call before a worker thread exits.
+	void releaseThreadMagazines();
+
 	#ifdef MEMORYPOOL_DEBUG
 
 		/// perform internal consistency checking
@@ -784,6 +827,7 @@ inline Int MemoryPool::getUsedBlockCount() { return m_usedBlocksInPool; }
 inline Int MemoryPool::getTotalBlockCount() { return m_totalBlocksInPool; }
 inline Int MemoryPool::getPeakBlockCount() { return m_peakUsedBlocksInPool; }
 inline Int MemoryPool::getInitialBlockCount() { return m_initialAllocationCount; }
+inline Int MemoryPool::getOverflowBlockCount() { return m_overflowAllocationCount; }
 
 // ----------------------------------------------------------------------------
 inline DynamicMemoryAllocator *DynamicMemoryAllocator::getNextDmaInList() { return m_nextDmaInFactory; }
@@ -847,6 +891,20 @@ extern void userMemoryManagerInitPools();
 */
 extern void userMemoryAdjustPoolSize(const char *poolName, Int& initialAllocationCount, Int& overflowAllocationCount);
 
+/**
+	Size the pools from a profile written by userMemoryManagerWritePoolProfile(). Pools that are
+	created later start with the recorded peak, and existing pools are grown to it.
+	Returns false if the file can't be read.
+*/
+extern Bool userMemoryManagerReadPoolProfile(const char *filename);
+
+/**
+	Write the peak block count of every pool to a profile, in the format of MemoryPools.ini.
+	Where the file already has a higher peak for a pool, that one is kept, so that a batch
+	of runs can accumulate one profile. Returns false if the file can't be written.
+*/
+extern Bool userMemoryManagerWritePoolProfile(const char *filename);
+
 #ifdef __cplusplus
 
 #ifndef _OPERATOR_NEW_DEFINED_
@@ -65,6 +65,8 @@ class MemoryPoolFactory
 public:
 
 	void memoryPoolUsageReport( const char* filename, FILE *appendToFileInstead = NULL );
+	Int memoryPoolBenchmark();
+	void releaseThreadMagazines();
 
 #ifdef MEMORYPOOL_DEBUG
 
@@ -139,6 +141,12 @@ extern Bool isMemoryManagerOfficiallyInited();
 */
 extern void shutdownMemoryManager();
 
+/**
+	There are no pools to size, so these do nothing and return false.
+*/
+extern Bool userMemoryManagerReadPoolProfile(const char *filename);
+extern Bool userMemoryManagerWritePoolProfile(const char *filename);
+
 extern MemoryPoolFactory *TheMemoryPoolFactory;
 extern DynamicMemoryAllocator *TheDynamicMemoryAllocator;
 
@@ -80,6 +80,7 @@ class RAMFile : public File
 		Char				*m_data;											///< File data in memory
 		Int					m_pos;												///< current read position
 		Int					m_size;												///< size of file in memory
+		Bool				m_ownsData;										///< false when m_data points into memory owned by someone else, such as a mapped archive
 
 	public:
 
@@ -107,6 +108,7 @@ class RAMFile : public File
 
 		virtual Bool	open( File *file );																	///< Open file for fast RAM access
 		virtual Bool	openFromArchive(File *archiveFile, const AsciiString& filename, Int offset, Int size); ///< copy file data from the given file at the given offset for the given size.
+		Bool					openFromMemory(const Char *data, const AsciiString& filename, Int size); ///< read file data in place from memory that outlives this file, without copying it.
 		virtual Bool	copyDataToFile(File *localFile);										///< write the contents of the RAM file to the given local file.  This could be REALLY slow.
 
 		/**
@@ -28,6 +28,11 @@ public:
 	// Returns exit code 0 if all replays were successfully simulated without mismatches
 	static int simulateReplays(const std::vector<AsciiString> &filenames, int maxProcesses);
 
+	// Simulate replays whose filenames are received line by line on the standard input until it is closed.
+	// This is run by persistent worker processes, so that the game data is only loaded once per worker.
+	// Returns exit code 1 if the standard input could not be read
+	static int simulateReplaysAsWorker();
+
 	static void stop() { s_isRunning = false; }
 
 	static Bool isRunning() { return s_isRunning; }
@@ -38,6 +43,8 @@ private:
 
 	static int simulateReplaysInThisProcess(const std::vector<AsciiString> &filenames);
 	static int simulateReplaysInWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses);
+	static int simulateReplaysInPersistentWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses);
+	static int simulateReplayHeadless(const AsciiString &filename);
 	static std::vector<AsciiString> resolveFilenameWildcards(const std::vector<AsciiString> &filenames);
 
 private:
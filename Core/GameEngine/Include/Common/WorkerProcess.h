@@ -21,12 +21,19 @@
 // Helper class that allows you to start a worker process and retrieve its exit code
 // and console output as a string.
 // It also makes sure that the started process is killed in case our process exits in any way.
+// Optionally, a pipe to the standard input of the process is created so it can be sent more work while running.
 class WorkerProcess
 {
 public:
 	WorkerProcess();
 
-	bool startProcess(UnicodeString command);
+	bool startProcess(UnicodeString command, bool redirectStdInput = false);
+
+	// Write to the standard input of the process. Requires the process to be started with redirectStdInput.
+	bool writeStdInput(const AsciiString& input);
+
+	// Close the standard input of the process, so it knows that no more input will follow.
+	void closeStdInput();
 
 	void update();
 
@@ -38,6 +45,11 @@ public:
 	DWORD getExitCode() const;
 	AsciiString getStdOutput() const;
 
+	// Remove all output up to and including the first line starting with linePrefix.
+	// The output before that line is written to output and the line itself to line (without the line break).
+	// Returns false if no such line was received yet.
+	bool takeStdOutputUntilLine(const char* linePrefix, AsciiString& output, AsciiString& line);
+
 	// Terminate Process if it's running
 	void kill();
 
@@ -49,6 +61,7 @@ private:
 private:
 	HANDLE m_processHandle;
 	HANDLE m_readHandle;
+	HANDLE m_writeHandle;
 	HANDLE m_jobHandle;
 	AsciiString m_stdOutput;
 	DWORD m_exitcode;
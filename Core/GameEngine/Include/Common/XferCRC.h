@@ -34,6 +34,7 @@
 
 // USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
 #include "Common/Xfer.h"
+#include "utility/endian_compat.h"
 
 // FORWARD REFERENCES /////////////////////////////////////////////////////////////////////////////
 class Snapshot;
@@ -57,6 +58,22 @@ public:
 
 	virtual void xferSnapshot( Snapshot *snapshot );		///< entry point for xfering a snapshot
 
+	// TheSuperHackers @performance The fixed size types are added to the CRC right here instead of
+	// making a second virtual call into the generic xferImplementation. This must give the same CRC.
+	virtual void xferByte( Byte *byteData ) { addCRCData( byteData, sizeof( Byte ) ); }
+	virtual void xferUnsignedByte( UnsignedByte *unsignedByteData ) { addCRCData( unsignedByteData, sizeof( UnsignedByte ) ); }
+	virtual void xferBool( Bool *boolData ) { addCRCData( boolData, sizeof( Bool ) ); }
+	virtual void xferInt( Int *intData ) { addCRCData( intData, sizeof( Int ) ); }
+	virtual void xferInt64( Int64 *int64Data ) { addCRCData( int64Data, sizeof( Int64 ) ); }
+	virtual void xferUnsignedInt( UnsignedInt *unsignedIntData ) { addCRCData( unsignedIntData, sizeof( UnsignedInt ) ); }
+	virtual void xferShort( Short *shortData ) { addCRCData( shortData, sizeof( Short ) ); }
+	virtual void xferUnsignedShort( UnsignedShort *unsignedShortData ) { addCRCData( unsignedShortData, sizeof( UnsignedShort ) ); }
+	virtual void xferReal( Real *realData ) { addCRCData( realData, sizeof( Real ) ); }
+	virtual void xferCoord3D( Coord3D *coord3D );
+	virtual void xferColor( Color *color ) { addCRCData( color, sizeof( Color ) ); }
+	virtual void xferObjectID( ObjectID *objectID ) { addCRCData( objectID, sizeof( ObjectID ) ); }
+	virtual void xferDrawableID( DrawableID *drawableID ) { addCRCData( drawableID, sizeof( DrawableID ) ); }
+
 	// Xfer CRC methods
 	virtual UnsignedInt getCRC( void );										///< get computed CRC in network byte order
 
@@ -65,10 +82,50 @@ protected:
 	virtual void xferImplementation( void *data, Int dataSize );
 
 	inline void addCRC( UnsignedInt val );								///< CRC a 4-byte block
+	inline void addCRCData( const void *data, Int dataSize );	///< CRC a small block of a size known at compile time
 
 	UnsignedInt m_crc;
 
 };
 
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+inline void XferCRC::addCRC( UnsignedInt val )
+{
+	m_crc = (m_crc << 1) + htobe(val) + ((m_crc >> 31) & 0x01);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Same as xferImplementation, written so that the compiler can remove the loop and the switch
+	* when dataSize is a constant */
+//-------------------------------------------------------------------------------------------------
+inline void XferCRC::addCRCData( const void *data, Int dataSize )
+{
+	const UnsignedByte *c = (const UnsignedByte *)data;
+	for (; dataSize >= 4; dataSize -= 4, c += 4)
+	{
+		UnsignedInt word;
+		memcpy(&word, c, sizeof(word));
+		addCRC(word);
+	}
+
+	UnsignedInt val = 0;
+	switch (dataSize)
+	{
+	case 3:
+		val += (c[2] << 16);
+		FALLTHROUGH;
+	case 2:
+		val += (c[1] << 8);
+		FALLTHROUGH;
+	case 1:
+		val += c[0];
+		m_crc = (m_crc << 1) + val + ((m_crc >> 31) & 0x01);
+		FALLTHROUGH;
+	default:
+		break;
+	}
+}
+
 #endif // __XFERDISKWRITE_H_
 
@@ -58,6 +58,21 @@ public:
 	virtual void xferAsciiString( AsciiString *asciiStringData );  ///< xfer ascii string (need our own)
 	virtual void xferUnicodeString( UnicodeString *unicodeStringData );	///< xfer unicode string (need our own);
 
+	// Take the fixed size types back through xferImplementation, so that they are written to the file.
+	virtual void xferByte( Byte *byteData ) { Xfer::xferByte( byteData ); }
+	virtual void xferUnsignedByte( UnsignedByte *unsignedByteData ) { Xfer::xferUnsignedByte( unsignedByteData ); }
+	virtual void xferBool( Bool *boolData ) { Xfer::xferBool( boolData ); }
+	virtual void xferInt( Int *intData ) { Xfer::xferInt( intData ); }
+	virtual void xferInt64( Int64 *int64Data ) { Xfer::xferInt64( int64Data ); }
+	virtual void xferUnsignedInt( UnsignedInt *unsignedIntData ) { Xfer::xferUnsignedInt( unsignedIntData ); }
+	virtual void xferShort( Short *shortData ) { Xfer::xferShort( shortData ); }
+	virtual void xferUnsignedShort( UnsignedShort *unsignedShortData ) { Xfer::xferUnsignedShort( unsignedShortData ); }
+	virtual void xferReal( Real *realData ) { Xfer::xferReal( realData ); }
+	virtual void xferCoord3D( Coord3D *coord3D ) { Xfer::xferCoord3D( coord3D ); }
+	virtual void xferColor( Color *color ) { Xfer::xferColor( color ); }
+	virtual void xferObjectID( ObjectID *objectID ) { Xfer::xferObjectID( objectID ); }
+	virtual void xferDrawableID( DrawableID *drawableID ) { Xfer::xferDrawableID( drawableID ); }
+
 protected:
 
 	virtual void xferImplementation( void *data, Int dataSize );
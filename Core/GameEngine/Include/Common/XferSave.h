@@ -55,6 +55,7 @@ public:
 	// Xfer methods
 	virtual void open( AsciiString identifier );		///< open file for writing
 	virtual void close( void );											///< close file
+	void flush( void ) { flushBuffer(); }						///< write buffered data to the file, throws on error
 	virtual Int beginBlock( void );									///< write placeholder block size
 	virtual void endBlock( void );									///< backup to last begin block and write size
 	virtual void skip( Int dataSize );							///< skipping during a write is a no-op
@@ -65,14 +66,54 @@ public:
 	virtual void xferAsciiString( AsciiString *asciiStringData );  ///< xfer ascii string (need our own)
 	virtual void xferUnicodeString( UnicodeString *unicodeStringData );	///< xfer unicode string (need our own);
 
+	// TheSuperHackers @performance The fixed size types are copied into the write buffer right here
+	// instead of making a second virtual call into the generic xferImplementation.
+	virtual void xferByte( Byte *byteData ) { writeData( byteData, sizeof( Byte ) ); }
+	virtual void xferUnsignedByte( UnsignedByte *unsignedByteData ) { writeData( unsignedByteData, sizeof( UnsignedByte ) ); }
+	virtual void xferBool( Bool *boolData ) { writeData( boolData, sizeof( Bool ) ); }
+	virtual void xferInt( Int *intData ) { writeData( intData, sizeof( Int ) ); }
+	virtual void xferInt64( Int64 *int64Data ) { writeData( int64Data, sizeof( Int64 ) ); }
+	virtual void xferUnsignedInt( UnsignedInt *unsignedIntData ) { writeData( unsignedIntData, sizeof( UnsignedInt ) ); }
+	virtual void xferShort( Short *shortData ) { writeData( shortData, sizeof( Short ) ); }
+	virtual void xferUnsignedShort( UnsignedShort *unsignedShortData ) { writeData( unsignedShortData, sizeof( UnsignedShort ) ); }
+	virtual void xferReal( Real *realData ) { writeData( realData, sizeof( Real ) ); }
+	virtual void xferCoord3D( Coord3D *coord3D );
+	virtual void xferColor( Color *color ) { writeData( color, sizeof( Color ) ); }
+	virtual void xferObjectID( ObjectID *objectID ) { writeData( objectID, sizeof( ObjectID ) ); }
+	virtual void xferDrawableID( DrawableID *drawableID ) { writeData( drawableID, sizeof( DrawableID ) ); }
+
 protected:
 
+	enum { WRITE_BUFFER_SIZE = 64 * 1024 };
+
 	virtual void xferImplementation( void *data, Int dataSize );		///< the xfer implementation
 
+	inline void writeData( const void *data, Int dataSize );		///< copy data into the write buffer
+	void writeDataAfterFlush( const void *data, Int dataSize );	///< write the buffer to the file, then copy data
+	void flushBuffer( void );																		///< write the buffer to the file
+
 	FILE * m_fileFP;																			///< pointer to file
 	XferBlockData *m_blockStack;													///< stack of block data
 
+	char *m_buffer;																				///< data not yet written to the file
+	Int m_bufferUsed;																			///< bytes used in m_buffer
+	XferFilePos m_bufferFilePos;													///< file position of the start of m_buffer
+
 };
 
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+inline void XferSave::writeData( const void *data, Int dataSize )
+{
+	if( m_bufferUsed + dataSize > WRITE_BUFFER_SIZE )
+	{
+		writeDataAfterFlush( data, dataSize );
+		return;
+	}
+
+	memcpy( m_buffer + m_bufferUsed, data, dataSize );
+	m_bufferUsed += dataSize;
+}
+
 #endif // __XFER_SAVE_H_
 
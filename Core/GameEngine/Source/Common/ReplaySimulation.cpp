@@ -34,6 +34,17 @@ UnsignedInt ReplaySimulation::s_replayCount = 0;
 
 namespace
 {
+// Line written by a persistent worker process after each replay, followed by the exit code of that replay.
+const char JobDoneLinePrefix[] = "ReplayJobDone: ";
+
+struct PersistentWorker
+{
+	PersistentWorker() : jobIndex(-1) {}
+
+	WorkerProcess process;
+	int jobIndex; ///< Index of the replay the worker currently simulates, or -1 if idle
+};
+
 int countProcessesRunning(const std::vector<WorkerProcess>& processes)
 {
 	int numProcessesRunning = 0;
@@ -77,45 +88,7 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 	DWORD totalStartTimeMillis = GetTickCount();
 	for (size_t i = 0; i < filenames.size(); i++)
 	{
-		AsciiString filename = filenames[i];
-		printf("Simulating Replay \"%s\"\n", filename.str());
-		fflush(stdout);
-		DWORD startTimeMillis = GetTickCount();
-		if (TheRecorder->simulateReplay(filename))
-		{
-			UnsignedInt totalTimeSec = TheRecorder->getPlaybackFrameCount() / LOGICFRAMES_PER_SECOND;
-			while (TheRecorder->isPlaybackInProgress())
-			{
-				TheGameClient->updateHeadless();
-
-				const int progressFrameInterval = 10*60*LOGICFRAMES_PER_SECOND;
-				if (TheGameLogic->getFrame() != 0 && TheGameLogic->getFrame() % progressFrameInterval == 0)
-				{
-					// Print progress report
-					UnsignedInt gameTimeSec = TheGameLogic->getFrame() / LOGICFRAMES_PER_SECOND;
-					UnsignedInt realTimeSec = (GetTickCount()-startTimeMillis) / 1000;
-					printf("Elapsed Time: %02d:%02d Game Time: %02d:%02d/%02d:%02d\n",
-							realTimeSec/60, realTimeSec%60, gameTimeSec/60, gameTimeSec%60, totalTimeSec/60, totalTimeSec%60);
-					fflush(stdout);
-				}
-				TheGameLogic->UPDATE();
-				if (TheRecorder->sawCRCMismatch())
-				{
-					numErrors++;
-					break;
-				}
-			}
-			UnsignedInt gameTimeSec = TheGameLogic->getFrame() / LOGICFRAMES_PER_SECOND;
-			UnsignedInt realTimeSec = (GetTickCount()-startTimeMillis) / 1000;
-			printf("Elapsed Time: %02d:%02d Game Time: %02d:%02d/%02d:%02d\n",
-					realTimeSec/60, realTimeSec%60, gameTimeSec/60, gameTimeSec%60, totalTimeSec/60, totalTimeSec%60);
-			fflush(stdout);
-		}
-		else
-		{
-			printf("Cannot open replay\n");
-			numErrors++;
-		}
+		numErrors += simulateReplayHeadless(filenames[i]);
 	}
 	if (filenames.size() > 1)
 	{
@@ -129,6 +102,70 @@ int ReplaySimulation::simulateReplaysInThisProcess(const std::vector<AsciiString
 	return numErrors != 0 ? 1 : 0;
 }
 
+int ReplaySimulation::simulateReplayHeadless(const AsciiString &filename)
+{
+	int numErrors = 0;
+	printf("Simulating Replay \"%s\"\n", filename.str());
+	fflush(stdout);
+	DWORD startTimeMillis = GetTickCount();
+	if (TheRecorder->simulateReplay(filename))
+	{
+		UnsignedInt totalTimeSec = TheRecorder->getPlaybackFrameCount() / LOGICFRAMES_PER_SECOND;
+		while (TheRecorder->isPlaybackInProgress())
+		{
+			TheGameClient->updateHeadless();
+
+			const int progressFrameInterval = 10*60*LOGICFRAMES_PER_SECOND;
+			if (TheGameLogic->getFrame() != 0 && TheGameLogic->getFrame() % progressFrameInterval == 0)
+			{
+				// Print progress report
+				UnsignedInt gameTimeSec = TheGameLogic->getFrame() / LOGICFRAMES_PER_SECOND;
+				UnsignedInt realTimeSec = (GetTickCount()-startTimeMillis) / 1000;
+				printf("Elapsed Time: %02d:%02d Game Time: %02d:%02d/%02d:%02d\n",
+						realTimeSec/60, realTimeSec%60, gameTimeSec/60, gameTimeSec%60, totalTimeSec/60, totalTimeSec%60);
+				fflush(stdout);
+			}
+			TheGameLogic->UPDATE();
+			if (TheRecorder->sawCRCMismatch())
+			{
+				numErrors++;
+				break;
+			}
+		}
+		UnsignedInt gameTimeSec = TheGameLogic->getFrame() / LOGICFRAMES_PER_SECOND;
+		UnsignedInt realTimeSec = (GetTickCount()-startTimeMillis) / 1000;
+		printf("Elapsed Time: %02d:%02d Game Time: %02d:%02d/%02d:%02d\n",
+				realTimeSec/60, realTimeSec%60, gameTimeSec/60, gameTimeSec%60, totalTimeSec/60, totalTimeSec%60);
+		fflush(stdout);
+	}
+	else
+	{
+		printf("Cannot open replay\n");
+		numErrors++;
+	}
+	return numErrors;
+}
+
+int ReplaySimulation::simulateReplaysAsWorker()
+{
+	// The parent process sends one replay filename per line and closes our input when all replays are done.
+	// The game data stays loaded between the replays, only the game logic is reset when the next replay starts.
+	char buffer[1024];
+	while (fgets(buffer, ARRAY_SIZE(buffer), stdin) != NULL)
+	{
+		AsciiString filename = buffer;
+		filename.trimEnd();
+		if (filename.isEmpty())
+			continue;
+
+		int numErrors = simulateReplayHeadless(filename);
+
+		printf("%s%d\n", JobDoneLinePrefix, numErrors != 0 ? 1 : 0);
+		fflush(stdout);
+	}
+	return ferror(stdin) ? 1 : 0;
+}
+
 int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses)
 {
 	DWORD totalStartTimeMillis = GetTickCount();
@@ -203,6 +240,125 @@ int ReplaySimulation::simulateReplaysInWorkerProcesses(const std::vector<AsciiSt
 	return numErrors != 0 ? 1 : 0;
 }
 
+int ReplaySimulation::simulateReplaysInPersistentWorkerProcesses(const std::vector<AsciiString> &filenames, int maxProcesses)
+{
+	DWORD totalStartTimeMillis = GetTickCount();
+
+	WideChar exePath[1024];
+	GetModuleFileNameW(NULL, exePath, ARRAY_SIZE(exePath));
+
+	UnicodeString command;
+	command.format(L"\"%s\"%s -headless -replayWorker",
+		exePath,
+		TheGlobalData->m_windowed ? L" -win" : L"");
+
+	const int numFilenames = static_cast<int>(filenames.size());
+	std::vector<PersistentWorker> workers(min(maxProcesses, numFilenames));
+	std::vector<AsciiString> jobOutputs(numFilenames);
+	std::vector<int> jobExitCodes(numFilenames, -1);
+	int filenamePositionStarted = 0;
+	int filenamePositionDone = 0;
+	int numErrors = 0;
+
+	while (filenamePositionDone < numFilenames)
+	{
+		size_t i;
+		for (i = 0; i < workers.size(); ++i)
+		{
+			PersistentWorker &worker = workers[i];
+			worker.process.update();
+
+			// Collect the results of all replays this worker has finished
+			AsciiString output;
+			AsciiString line;
+			while (worker.jobIndex >= 0 && worker.process.takeStdOutputUntilLine(JobDoneLinePrefix, output, line))
+			{
+				jobOutputs[worker.jobIndex] = output;
+				jobExitCodes[worker.jobIndex] = atoi(line.str() + strlen(JobDoneLinePrefix));
+				worker.jobIndex = -1;
+			}
+
+			if (worker.process.isDone())
+			{
+				// The worker exited in the middle of a replay, most likely due to a crash.
+				// Fail the replay and start a fresh worker for the remaining ones.
+				if (worker.jobIndex >= 0)
+				{
+					jobOutputs[worker.jobIndex] = worker.process.getStdOutput();
+					jobExitCodes[worker.jobIndex] = worker.process.getExitCode() != 0 ? worker.process.getExitCode() : 1;
+					worker.jobIndex = -1;
+				}
+				worker.process = WorkerProcess();
+			}
+
+			// Hand out the next replay to an idle worker
+			if (worker.jobIndex < 0 && filenamePositionStarted < numFilenames)
+			{
+				if (!worker.process.isRunning() && !worker.process.startProcess(command, true))
+				{
+					jobOutputs[filenamePositionStarted] = "Cannot start worker process\n";
+					jobExitCodes[filenamePositionStarted] = 1;
+					filenamePositionStarted++;
+					continue;
+				}
+
+				AsciiString job = filenames[filenamePositionStarted];
+				job.concat('\n');
+				worker.process.writeStdInput(job);
+				worker.jobIndex = filenamePositionStarted;
+				filenamePositionStarted++;
+			}
+
+			// Idle workers are no longer needed when all replays have been handed out
+			if (worker.jobIndex < 0 && filenamePositionStarted == numFilenames)
+				worker.process.closeStdInput();
+		}
+
+		// Print results of finished replays in order
+		while (filenamePositionDone < numFilenames && jobExitCodes[filenamePositionDone] >= 0)
+		{
+			printf("%d/%d %s", filenamePositionDone+1, numFilenames, jobOutputs[filenamePositionDone].str());
+			if (jobExitCodes[filenamePositionDone] != 0)
+				printf("Error!\n");
+			fflush(stdout);
+			numErrors += jobExitCodes[filenamePositionDone] == 0 ? 0 : 1;
+			jobOutputs[filenamePositionDone].clear();
+			filenamePositionDone++;
+		}
+
+		if (filenamePositionDone == numFilenames)
+			break;
+
+		// Workers report back after every replay, so poll more often than in simulateReplaysInWorkerProcesses
+		// to keep them busy. This is still rare enough to not take away noticeable CPU time from them.
+		Sleep(10);
+	}
+
+	// Let the workers shut down on their own, now that their input is closed
+	size_t i;
+	for (i = 0; i < workers.size(); ++i)
+	{
+		workers[i].process.closeStdInput();
+		while (workers[i].process.isRunning())
+		{
+			workers[i].process.update();
+			if (workers[i].process.isRunning())
+				Sleep(10);
+		}
+	}
+
+	DEBUG_ASSERTCRASH(filenamePositionStarted == numFilenames, ("inconsistent file position 1"));
+	DEBUG_ASSERTCRASH(filenamePositionDone == numFilenames, ("inconsistent file position 2"));
+
+	printf("Simulation of all replays completed. Errors occurred: %d\n", numErrors);
+
+	UnsignedInt realTime = (GetTickCount()-totalStartTimeMillis) / 1000;
+	printf("Total Wall Time: %d:%02d:%02d\n", realTime/60/60, realTime/60%60, realTime%60);
+	fflush(stdout);
+
+	return numErrors != 0 ? 1 : 0;
+}
+
 std::vector<AsciiString> ReplaySimulation::resolveFilenameWildcards(const std::vector<AsciiString> &filenames)
 {
 	// If some filename contains wildcards, search for actual filenames.
@@ -250,6 +406,8 @@ int ReplaySimulation::simulateReplays(const std::vector<AsciiString> &filenames,
 	std::vector<AsciiString> filenamesResolved = resolveFilenameWildcards(filenames);
 	if (maxProcesses == SIMULATE_REPLAYS_SEQUENTIAL)
 		return simulateReplaysInThisProcess(filenamesResolved);
+	else if (TheGlobalData->m_simulateReplaysInPersistentJobs && TheGlobalData->m_headless)
+		return simulateReplaysInPersistentWorkerProcesses(filenamesResolved, maxProcesses);
 	else
 		return simulateReplaysInWorkerProcesses(filenamesResolved, maxProcesses);
 }
@@ -0,0 +1,301 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ArchiveFileCache.cpp
+// Cache file of the directories of all archive files, to skip reading them at startup
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "Common/ArchiveFileCache.h"
+
+#include "Common/ArchiveFile.h"
+#include "Common/LocalFileSystem.h"
+
+// The cache file is written in the byte order of the machine, it is not meant to be shared.
+//
+// header:  "BIGC", UnsignedInt version, UnsignedInt archive count
+// archive: UnsignedInt name length, name without terminator, FileInfo,
+//          UnsignedInt record bytes, records
+// record:  UnsignedInt offset, UnsignedInt size, full path with terminator
+static const char ArchiveFileCacheIdentifier[4] = { 'B', 'I', 'G', 'C' };
+static const UnsignedInt ArchiveFileCacheVersion = 1;
+
+//-------------------------------------------------------------------------------------------------
+static Bool readCacheData( const char *&pos, const char *end, void *data, size_t size )
+{
+	if ((size_t)(end - pos) < size)
+		return FALSE;
+
+	memcpy(data, pos, size);
+	pos += size;
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+static void writeCacheData( std::vector<char> &buffer, const void *data, size_t size )
+{
+	buffer.insert(buffer.end(), (const char *)data, (const char *)data + size);
+}
+
+//-------------------------------------------------------------------------------------------------
+static void writeCacheRecords( std::vector<char> &records, const DetailedArchivedDirectoryInfo *dirInfo, const AsciiString& dirPath )
+{
+	DetailedArchivedDirectoryInfoMap::const_iterator diriter = dirInfo->m_directories.begin();
+	for (; diriter != dirInfo->m_directories.end(); ++diriter)
+	{
+		AsciiString path = dirPath;
+		path.concat(diriter->second.m_directoryName);
+		path.concat('\\');
+		writeCacheRecords(records, &diriter->second, path);
+	}
+
+	ArchivedFileInfoMap::const_iterator fileiter = dirInfo->m_files.begin();
+	for (; fileiter != dirInfo->m_files.end(); ++fileiter)
+	{
+		const ArchivedFileInfo &fileInfo = fileiter->second;
+		writeCacheData(records, &fileInfo.m_offset, sizeof(fileInfo.m_offset));
+		writeCacheData(records, &fileInfo.m_size, sizeof(fileInfo.m_size));
+		writeCacheData(records, dirPath.str(), dirPath.getLength());
+		writeCacheData(records, fileInfo.m_filename.str(), fileInfo.m_filename.getLength() + 1);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+static Bool isSameFileInfo( const FileInfo &a, const FileInfo &b )
+{
+	return a.sizeHigh == b.sizeHigh && a.sizeLow == b.sizeLow
+		&& a.timestampHigh == b.timestampHigh && a.timestampLow == b.timestampLow;
+}
+
+//-------------------------------------------------------------------------------------------------
+ArchiveFileCache::ArchiveFileCache() :
+	m_data(NULL),
+	m_filledCount(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+ArchiveFileCache::~ArchiveFileCache()
+{
+	clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+void ArchiveFileCache::clear( void )
+{
+	m_archives.clear();
+	delete [] m_data;
+	m_data = NULL;
+	m_filledCount = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool ArchiveFileCache::read( const Char *filename )
+{
+	clear();
+
+	FILE *fp = fopen(filename, "rb");
+	if (fp == NULL)
+		return FALSE;
+
+	fseek(fp, 0, SEEK_END);
+	const long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	if (size <= 0)
+	{
+		fclose(fp);
+		return FALSE;
+	}
+
+	m_data = NEW char[size];
+	const Bool isRead = fread(m_data, 1, size, fp) == (size_t)size;
+	fclose(fp);
+
+	const char *pos = m_data;
+	const char *end = m_data + (isRead ? size : 0);
+
+	char identifier[4];
+	UnsignedInt version = 0;
+	UnsignedInt archiveCount = 0;
+	Bool isValid = readCacheData(pos, end, identifier, sizeof(identifier))
+		&& memcmp(identifier, ArchiveFileCacheIdentifier, sizeof(identifier)) == 0
+		&& readCacheData(pos, end, &version, sizeof(version))
+		&& version == ArchiveFileCacheVersion
+		&& readCacheData(pos, end, &archiveCount, sizeof(archiveCount));
+
+	for (UnsignedInt i = 0; isValid && i < archiveCount; ++i)
+	{
+		UnsignedInt nameLength = 0;
+		UnsignedInt recordBytes = 0;
+		CachedArchive archive;
+
+		isValid = readCacheData(pos, end, &nameLength, sizeof(nameLength))
+			&& nameLength < _MAX_PATH && (UnsignedInt)(end - pos) >= nameLength;
+		if (!isValid)
+			break;
+
+		char archiveFilename[_MAX_PATH];
+		memcpy(archiveFilename, pos, nameLength);
+		archiveFilename[nameLength] = 0;
+		pos += nameLength;
+
+		isValid = readCacheData(pos, end, &archive.fileInfo, sizeof(archive.fileInfo))
+			&& readCacheData(pos, end, &recordBytes, sizeof(recordBytes))
+			&& (UnsignedInt)(end - pos) >= recordBytes;
+		if (!isValid)
+			break;
+
+		archive.records = pos;
+		archive.recordsEnd = pos + recordBytes;
+		pos += recordBytes;
+
+		// Check the records once here, so that fillArchiveFile can trust them.
+		const char *record = archive.records;
+		while (isValid && record < archive.recordsEnd)
+		{
+			UnsignedInt value;
+			isValid = readCacheData(record, archive.recordsEnd, &value, sizeof(value))
+				&& readCacheData(record, archive.recordsEnd, &value, sizeof(value));
+			if (!isValid)
+				break;
+
+			const char *terminator = (const char *)memchr(record, 0, archive.recordsEnd - record);
+			isValid = terminator != NULL && terminator - record < _MAX_PATH;
+			record = terminator + 1;
+		}
+
+		m_archives[AsciiString(archiveFilename)] = archive;
+	}
+
+	if (!isValid || pos != end)
+	{
+		DEBUG_LOG(("ArchiveFileCache::read - %s is invalid, the archive files are read instead", filename));
+		clear();
+		return FALSE;
+	}
+
+	DEBUG_LOG(("ArchiveFileCache::read - %d archive files in %s", (Int)m_archives.size(), filename));
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool ArchiveFileCache::fillArchiveFile( const Char *archiveFilename, ArchiveFile *archiveFile ) const
+{
+	// This runs on several threads at once, so it must not share any AsciiString with the others.
+	AsciiString key = archiveFilename;
+	key.toLower();
+
+	CachedArchiveMap::const_iterator it = m_archives.find(key);
+	if (it == m_archives.end())
+		return FALSE;
+
+	const CachedArchive &archive = it->second;
+	FileInfo fileInfo;
+	if (!TheLocalFileSystem->getFileInfo(AsciiString(archiveFilename), &fileInfo) || !isSameFileInfo(fileInfo, archive.fileInfo))
+		return FALSE;
+
+	ArchivedFileInfo archivedFileInfo;
+	archivedFileInfo.m_archiveFilename = key;
+
+	char path[_MAX_PATH];
+	const char *record = archive.records;
+	while (record < archive.recordsEnd)
+	{
+		readCacheData(record, archive.recordsEnd, &archivedFileInfo.m_offset, sizeof(archivedFileInfo.m_offset));
+		readCacheData(record, archive.recordsEnd, &archivedFileInfo.m_size, sizeof(archivedFileInfo.m_size));
+
+		const Int pathLength = strlen(record);
+		const char *filename = record + pathLength;
+		while (filename > record && filename[-1] != '\\')
+			--filename;
+
+		memcpy(path, record, filename - record);
+		path[filename - record] = 0;
+
+		archivedFileInfo.m_filename = filename;
+		archiveFile->addFile(AsciiString(path), &archivedFileInfo);
+
+		record += pathLength + 1;
+	}
+
+	InterlockedIncrement(&m_filledCount);
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool ArchiveFileCache::isUpToDate( const ArchiveFileMap &archiveFiles ) const
+{
+	return (size_t)m_filledCount == archiveFiles.size() && m_archives.size() == archiveFiles.size();
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool ArchiveFileCache::write( const Char *filename, const ArchiveFileMap &archiveFiles ) const
+{
+	std::vector<char> buffer;
+	std::vector<char> records;
+
+	UnsignedInt archiveCount = 0;
+	writeCacheData(buffer, ArchiveFileCacheIdentifier, sizeof(ArchiveFileCacheIdentifier));
+	writeCacheData(buffer, &ArchiveFileCacheVersion, sizeof(ArchiveFileCacheVersion));
+	const size_t archiveCountPos = buffer.size();
+	writeCacheData(buffer, &archiveCount, sizeof(archiveCount));
+
+	for (ArchiveFileMap::const_iterator it = archiveFiles.begin(); it != archiveFiles.end(); ++it)
+	{
+		FileInfo fileInfo;
+		if (it->second == NULL || !TheLocalFileSystem->getFileInfo(it->first, &fileInfo))
+			continue;
+
+		AsciiString archiveFilename = it->first;
+		archiveFilename.toLower();
+
+		records.clear();
+		writeCacheRecords(records, it->second->getRootDirectory(), AsciiString::TheEmptyString);
+
+		const UnsignedInt nameLength = archiveFilename.getLength();
+		const UnsignedInt recordBytes = records.size();
+		writeCacheData(buffer, &nameLength, sizeof(nameLength));
+		writeCacheData(buffer, archiveFilename.str(), nameLength);
+		writeCacheData(buffer, &fileInfo, sizeof(fileInfo));
+		writeCacheData(buffer, &recordBytes, sizeof(recordBytes));
+		if (!records.empty())
+			writeCacheData(buffer, &records[0], records.size());
+
+		++archiveCount;
+	}
+
+	memcpy(&buffer[archiveCountPos], &archiveCount, sizeof(archiveCount));
+
+	FILE *fp = fopen(filename, "wb");
+	if (fp == NULL)
+		return FALSE;
+
+	const Bool isWritten = fwrite(&buffer[0], 1, buffer.size(), fp) == buffer.size();
+	fclose(fp);
+
+	if (!isWritten)
+	{
+		// Don't leave a truncated cache behind.
+		remove(filename);
+		return FALSE;
+	}
+
+	DEBUG_LOG(("ArchiveFileCache::write - %d archive files in %s", archiveCount, filename));
+	return TRUE;
+}
@@ -46,9 +46,12 @@
 //----------------------------------------------------------------------------
 
 #include "PreRTS.h"
+#include <process.h>
 #include "Common/ArchiveFile.h"
+#include "Common/ArchiveFileCache.h"
 #include "Common/ArchiveFileSystem.h"
 #include "Common/AsciiString.h"
+#include "Common/CriticalSection.h"
 #include "Common/PerfTimer.h"
 
 
@@ -68,6 +71,15 @@
 //         Private Types
 //----------------------------------------------------------------------------
 
+struct OpenArchiveFilesJob
+{
+	ArchiveFileSystem *fileSystem;
+	const AsciiString *filenames;
+	ArchiveFile **archiveFiles;
+	LONG count;
+	volatile LONG nextIndex;
+};
+
 
 //----------------------------------------------------------------------------
 //         Private Data
@@ -92,21 +104,208 @@ ArchiveFileSystem *TheArchiveFileSystem = NULL;
 //         Private Functions
 //----------------------------------------------------------------------------
 
+//------------------------------------------------------
+// Writes the path in lower case with backslashes and without leading or doubled separators.
+// Returns FALSE if it does not fit the buffer. BIG file paths are read into _MAX_PATH
+// buffers, so no archived file has a longer path.
+//------------------------------------------------------
+static Bool normalizeArchivedPath(const Char *path, Char *buffer, Int bufferSize)
+{
+	Int length = 0;
+	for (; *path != 0; ++path) {
+		Char c = *path;
+		if (c == '\\' || c == '/') {
+			if (length == 0 || buffer[length - 1] == '\\') {
+				continue;
+			}
+			c = '\\';
+		} else {
+			c = (Char)tolower((UnsignedByte)c);
+		}
+
+		if (length + 1 >= bufferSize) {
+			return FALSE;
+		}
+		buffer[length++] = c;
+	}
+	buffer[length] = 0;
+
+	return length > 0;
+}
+
+//------------------------------------------------------
+// FNV-1a hash of a normalized path.
+//------------------------------------------------------
+static UnsignedInt hashArchivedPath(const Char *path)
+{
+	UnsignedInt hash = 2166136261u;
+	for (; *path != 0; ++path) {
+		hash ^= (UnsignedByte)*path;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+//------------------------------------------------------
+// Opens archive files of the job until there are none left. Runs on several threads at once.
+//------------------------------------------------------
+static void runOpenArchiveFilesJob(OpenArchiveFilesJob *job)
+{
+	for (;;) {
+		const LONG index = InterlockedIncrement(&job->nextIndex) - 1;
+		if (index >= job->count) {
+			break;
+		}
+		job->archiveFiles[index] = job->fileSystem->openArchiveFile(job->filenames[index].str());
+	}
+}
+
+//------------------------------------------------------
+static unsigned __stdcall openArchiveFilesThread(void *param)
+{
+	runOpenArchiveFilesJob((OpenArchiveFilesJob *)param);
+	TheMemoryPoolFactory->releaseThreadMagazines();
+	return 0;
+}
+
+//------------------------------------------------------
+static void addDirectoryToIndex(ArchivedFileIndex &index, const DetailedArchivedDirectoryInfo *dirInfo, const AsciiString& dirPath,
+	ArchiveFile *archiveFile, const AsciiString& archiveFilename, Bool overwrite)
+{
+	DetailedArchivedDirectoryInfoMap::const_iterator diriter = dirInfo->m_directories.begin();
+	for (; diriter != dirInfo->m_directories.end(); ++diriter) {
+		AsciiString path = dirPath;
+		path.concat(diriter->second.m_directoryName);
+		path.concat('\\');
+		addDirectoryToIndex(index, &diriter->second, path, archiveFile, archiveFilename, overwrite);
+	}
+
+	ArchivedFileInfoMap::const_iterator fileiter = dirInfo->m_files.begin();
+	for (; fileiter != dirInfo->m_files.end(); ++fileiter) {
+		AsciiString path = dirPath;
+		path.concat(fileiter->second.m_filename);
+		index.addFile(path, archiveFile, &fileiter->second, archiveFilename, overwrite);
+	}
+}
+
 
 
 //----------------------------------------------------------------------------
 //         Public Functions
 //----------------------------------------------------------------------------
 
+//------------------------------------------------------
+// ArchivedFileIndex
+//------------------------------------------------------
+void ArchivedFileIndex::clear( void )
+{
+	m_entries.clear();
+	m_count = 0;
+}
+
+void ArchivedFileIndex::addFile( const AsciiString& path, ArchiveFile *archiveFile, const ArchivedFileInfo *fileInfo, const AsciiString& archiveFilename, Bool overwrite )
+{
+	Char normalizedPath[_MAX_PATH];
+	if (!normalizeArchivedPath(path.str(), normalizedPath, _MAX_PATH)) {
+		DEBUG_CRASH(("ArchivedFileIndex::addFile - invalid path %s in %s", path.str(), archiveFilename.str()));
+		return;
+	}
+
+	if ((m_count + 1) * 2 > (Int)m_entries.size()) {
+		grow();
+	}
+
+	const UnsignedInt hash = hashArchivedPath(normalizedPath);
+	Entry &entry = m_entries[findSlot(normalizedPath, hash)];
+
+	if (entry.m_path.isEmpty()) {
+		entry.m_hash = hash;
+		entry.m_path = normalizedPath;
+		++m_count;
+	} else if (!overwrite && entry.m_archiveFile != NULL) {
+		// the first archive file to have this file keeps it.
+		return;
+	}
+
+	entry.m_archiveFile = archiveFile;
+	entry.m_fileInfo = fileInfo;
+	entry.m_archiveFilename = archiveFilename;
+}
+
+void ArchivedFileIndex::removeArchiveFile( const ArchiveFile *archiveFile )
+{
+	// Keep the paths, so that the probe sequences of the other entries stay intact.
+	for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+		if (it->m_archiveFile == archiveFile) {
+			it->m_archiveFile = NULL;
+			it->m_fileInfo = NULL;
+			it->m_archiveFilename.clear();
+		}
+	}
+}
+
+const ArchivedFileIndex::Entry *ArchivedFileIndex::findFile( const Char *path ) const
+{
+	if (m_count == 0) {
+		return NULL;
+	}
+
+	Char normalizedPath[_MAX_PATH];
+	if (!normalizeArchivedPath(path, normalizedPath, _MAX_PATH)) {
+		return NULL;
+	}
+
+	const Entry &entry = m_entries[findSlot(normalizedPath, hashArchivedPath(normalizedPath))];
+	if (entry.m_archiveFile == NULL) {
+		return NULL;
+	}
+
+	return &entry;
+}
+
+Int ArchivedFileIndex::findSlot( const Char *normalizedPath, UnsignedInt hash ) const
+{
+	// Linear probing. The table is at most half full, so this always ends at a match or an unused slot.
+	const UnsignedInt mask = (UnsignedInt)m_entries.size() - 1;
+	for (UnsignedInt slot = hash & mask; ; slot = (slot + 1) & mask) {
+		const Entry &entry = m_entries[slot];
+		if (entry.m_path.isEmpty()) {
+			return slot;
+		}
+		if (entry.m_hash == hash && strcmp(entry.m_path.str(), normalizedPath) == 0) {
+			return slot;
+		}
+	}
+}
+
+void ArchivedFileIndex::grow( void )
+{
+	const size_t MIN_SIZE = 1024;
+
+	std::vector<Entry> oldEntries;
+	oldEntries.swap(m_entries);
+	m_entries.resize(oldEntries.empty() ? MIN_SIZE : oldEntries.size() * 2);
+
+	for (std::vector<Entry>::const_iterator it = oldEntries.begin(); it != oldEntries.end(); ++it) {
+		if (!it->m_path.isEmpty()) {
+			m_entries[findSlot(it->m_path.str(), it->m_hash)] = *it;
+		}
+	}
+}
+
 //------------------------------------------------------
 // ArchivedFileInfo
 //------------------------------------------------------
-ArchiveFileSystem::ArchiveFileSystem()
+ArchiveFileSystem::ArchiveFileSystem() :
+	m_archiveCache(NULL)
 {
 }
 
 ArchiveFileSystem::~ArchiveFileSystem()
 {
+	delete m_archiveCache;
+	m_archiveCache = NULL;
+
 	ArchiveFileMap::iterator iter = m_archiveFileMap.begin();
 	while (iter != m_archiveFileMap.end()) {
 		ArchiveFile *file = iter->second;
@@ -118,51 +317,99 @@ ArchiveFileSystem::~ArchiveFileSystem()
 	}
 }
 
-void ArchiveFileSystem::loadIntoDirectoryTree(const ArchiveFile *archiveFile, const AsciiString& archiveFilename, Bool overwrite)
+void ArchiveFileSystem::loadIntoDirectoryTree(ArchiveFile *archiveFile, const AsciiString& archiveFilename, Bool overwrite)
 {
+	// TheSuperHackers @performance Files are added to a flat hash index of full paths instead of
+	// a tree of maps per directory, so that each lookup is a single hash probe.
+	addDirectoryToIndex(m_fileIndex, archiveFile->getRootDirectory(), AsciiString::TheEmptyString, archiveFile, archiveFilename, overwrite);
+}
 
-	FilenameList filenameList;
+void ArchiveFileSystem::readArchiveCache()
+{
+	if (TheGlobalData == NULL || TheGlobalData->m_archiveCacheFile.isEmpty()) {
+		return;
+	}
 
-	archiveFile->getFileListInDirectory(AsciiString(""), AsciiString(""), AsciiString("*"), filenameList, TRUE);
+	// A missing or outdated cache file is simply empty, then every archive file is read and the cache is written again.
+	delete m_archiveCache;
+	m_archiveCache = NEW ArchiveFileCache;
+	m_archiveCache->read(TheGlobalData->m_archiveCacheFile.str());
+}
 
-	FilenameListIter it = filenameList.begin();
+void ArchiveFileSystem::writeArchiveCache()
+{
+	if (m_archiveCache == NULL) {
+		return;
+	}
 
-	while (it != filenameList.end()) {
-		// add this filename to the directory tree.
-		AsciiString path = *it;
-		path.toLower();
-		AsciiString token;
-		AsciiString debugpath;
+	if (!m_archiveCache->isUpToDate(m_archiveFileMap)) {
+#ifdef DEBUG_LOGGING
+		Bool ret =
+#endif
+		m_archiveCache->write(TheGlobalData->m_archiveCacheFile.str(), m_archiveFileMap);
+		DEBUG_ASSERTLOG(ret, ("ArchiveFileSystem::writeArchiveCache - could not write %s", TheGlobalData->m_archiveCacheFile.str()));
+	}
 
-		ArchivedDirectoryInfo *dirInfo = &m_rootDirectory;
+	delete m_archiveCache;
+	m_archiveCache = NULL;
+}
 
-		Bool infoInPath;
-		infoInPath = path.nextToken(&token, "\\/");
+Bool ArchiveFileSystem::fillArchiveFileFromCache(const Char *filename, ArchiveFile *archiveFile) const
+{
+	if (m_archiveCache == NULL) {
+		return FALSE;
+	}
 
-		while (infoInPath && (!token.find('.') || path.find('.'))) {
-			ArchivedDirectoryInfoMap::iterator tempiter = dirInfo->m_directories.find(token);
-			if (tempiter == dirInfo->m_directories.end())
-			{
-				dirInfo->m_directories[token].clear();
-				dirInfo->m_directories[token].m_directoryName = token;
-			}
+	return m_archiveCache->fillArchiveFile(filename, archiveFile);
+}
 
-			dirInfo = &(dirInfo->m_directories[token]);
-			debugpath.concat(token);
-			debugpath.concat('\\');
-			infoInPath = path.nextToken(&token, "\\/");
-		}
+void ArchiveFileSystem::openArchiveFiles(const FilenameList &filenameList, std::vector<ArchiveFile *> &archiveFiles)
+{
+	// Copy the names first, the threads only read them.
+	std::vector<AsciiString> filenames(filenameList.begin(), filenameList.end());
+	archiveFiles.assign(filenames.size(), NULL);
+	if (filenames.empty()) {
+		return;
+	}
 
-		// token is the filename, and dirInfo is the directory that this file is in.
-		if (dirInfo->m_files.find(token) == dirInfo->m_files.end() || overwrite) {
-			AsciiString path2;
-			path2 = debugpath;
-			path2.concat(token);
-//			DEBUG_LOG(("ArchiveFileSystem::loadIntoDirectoryTree - adding file %s, archived in %s", path2.str(), archiveFilename.str()));
-			dirInfo->m_files[token] = archiveFilename;
+	OpenArchiveFilesJob job;
+	job.fileSystem = this;
+	job.filenames = &filenames[0];
+	job.archiveFiles = &archiveFiles[0];
+	job.count = (LONG)filenames.size();
+	job.nextIndex = 0;
+
+	// Opening an archive file reads its whole table of contents, which is mostly waiting for the disk.
+	const Int MAX_THREADS = 8;
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	Int threadCount = min((Int)systemInfo.dwNumberOfProcessors, MAX_THREADS);
+	threadCount = min(threadCount, (Int)job.count);
+
+	// Single threaded apps such as the WorldBuilder don't create the critical sections of the memory
+	// pools, the DMA and the strings. Without them the workers could not allocate safely.
+	if (TheMemoryPoolCriticalSection == NULL || TheDmaCriticalSection == NULL ||
+		TheAsciiStringCriticalSection == NULL || TheUnicodeStringCriticalSection == NULL) {
+		threadCount = 1;
+	}
+
+	// The calling thread is one of the workers.
+	HANDLE threads[MAX_THREADS];
+	Int startedCount = 0;
+	for (Int i = 1; i < threadCount; ++i) {
+		HANDLE thread = (HANDLE)_beginthreadex(NULL, 0, openArchiveFilesThread, &job, 0, NULL);
+		if (thread != NULL) {
+			threads[startedCount++] = thread;
 		}
+	}
 
-		it++;
+	runOpenArchiveFilesJob(&job);
+
+	if (startedCount > 0) {
+		WaitForMultipleObjects(startedCount, threads, TRUE, INFINITE);
+		for (Int i = 0; i < startedCount; ++i) {
+			CloseHandle(threads[i]);
+		}
 	}
 }
 
@@ -195,46 +442,18 @@ void ArchiveFileSystem::loadMods() {
 
 Bool ArchiveFileSystem::doesFileExist(const Char *filename) const
 {
-	AsciiString path = filename;
-	path.toLower();
-	AsciiString token;
-
-	const ArchivedDirectoryInfo *dirInfo = &m_rootDirectory;
-
-	path.nextToken(&token, "\\/");
-
-	while (!token.find('.') || path.find('.'))
-	{
-		ArchivedDirectoryInfoMap::const_iterator tempiter = dirInfo->m_directories.find(token);
-		if (tempiter != dirInfo->m_directories.end())
-		{
-			dirInfo = &tempiter->second;
-			path.nextToken(&token, "\\/");
-		}
-		else
-		{
-			// the directory doesn't exist, so return false
-			return FALSE;
-		}
-	}
-
-	// token is the filename, and dirInfo is the directory that this file is in.
-	if (dirInfo->m_files.find(token) == dirInfo->m_files.end()) {
-		return FALSE;
-	}
-	return TRUE;
+	return m_fileIndex.findFile(filename) != NULL;
 }
 
 File * ArchiveFileSystem::openFile(const Char *filename, Int access /* = 0 */)
 {
-	AsciiString archiveFilename;
-	archiveFilename = getArchiveFilenameForFile(AsciiString(filename));
+	const ArchivedFileIndex::Entry *entry = m_fileIndex.findFile(filename);
 
-	if (archiveFilename.getLength() == 0) {
+	if (entry == NULL) {
 		return NULL;
 	}
 
-	return m_archiveFileMap[archiveFilename]->openFile(filename, access);
+	return entry->m_archiveFile->openFile(entry->m_fileInfo, filename, access);
 }
 
 Bool ArchiveFileSystem::getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const
@@ -247,11 +466,10 @@ Bool ArchiveFileSystem::getFileInfo(const AsciiString& filename, FileInfo *fileI
 		return FALSE;
 	}
 
-	AsciiString archiveFilename = getArchiveFilenameForFile(filename);
-	ArchiveFileMap::const_iterator it = m_archiveFileMap.find(archiveFilename);
-	if (it != m_archiveFileMap.end())
+	const ArchivedFileIndex::Entry *entry = m_fileIndex.findFile(filename.str());
+	if (entry != NULL)
 	{
-		return it->second->getFileInfo(filename, fileInfo);
+		return entry->m_archiveFile->getFileInfo(filename, fileInfo);
 	}
 	else
 	{
@@ -261,55 +479,15 @@ Bool ArchiveFileSystem::getFileInfo(const AsciiString& filename, FileInfo *fileI
 
 AsciiString ArchiveFileSystem::getArchiveFilenameForFile(const AsciiString& filename) const
 {
-	AsciiString path;
-	path = filename;
-	path.toLower();
-	AsciiString token;
-	AsciiString debugpath;
-
-	const ArchivedDirectoryInfo *dirInfo = &m_rootDirectory;
-
-	path.nextToken(&token, "\\/");
-
-	while (!token.find('.') || path.find('.')) {
-
-		ArchivedDirectoryInfoMap::const_iterator it = dirInfo->m_directories.find(token);
-		if (it != dirInfo->m_directories.end())
-		{
-			dirInfo = &it->second;
-		}
-		else
-		{
-			// the directory doesn't exist, so return NULL
-
-			// dump the directories;
-			//DEBUG_LOG(("directory %s not found in %s in archive file system", token.str(), debugpath.str()));
-			//DEBUG_LOG(("directories in %s in archive file system are:", debugpath.str()));
-			//ArchivedDirectoryInfoMap::const_iterator it = dirInfo->m_directories.begin();
-			//while (it != dirInfo->m_directories.end()) {
-			//	DEBUG_LOG(("\t%s", it->second.m_directoryName.str()));
-			//	it++;
-			//}
-			//DEBUG_LOG(("end of directory list."));
-			return AsciiString::TheEmptyString;
-		}
-
-		debugpath.concat(token);
-		debugpath.concat('\\');
-
-		path.nextToken(&token, "\\/");
-	}
-
-	ArchivedFileLocationMap::const_iterator it = dirInfo->m_files.find(token);
-	if (it != dirInfo->m_files.end())
+	const ArchivedFileIndex::Entry *entry = m_fileIndex.findFile(filename.str());
+	if (entry != NULL)
 	{
-		return it->second;
+		return entry->m_archiveFilename;
 	}
 	else
 	{
 		return AsciiString::TheEmptyString;
 	}
-
 }
 
 void ArchiveFileSystem::getFileListInDirectory(const AsciiString& currentDirectory, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const
@@ -139,6 +139,24 @@ DECLARE_PERF_TIMER(MemoryPoolInitFilling)
 
 #endif
 
+#ifdef MEMORYPOOL_MAGAZINES
+
+	/**
+		TheSuperHackers @performance Every thread keeps a small magazine of free blocks per pool,
+		so that most allocations and frees don't need TheMemoryPoolCriticalSection. An empty
+		magazine is refilled with MAGAZINE_BATCH_SIZE blocks, and a full one hands back
+		MAGAZINE_BATCH_SIZE blocks, both under the lock. Pools beyond MAX_MAGAZINE_POOLS go
+		straight to the blobs.
+	*/
+	enum
+	{
+		MAX_MAGAZINE_POOLS	= 1024,
+		MAGAZINE_SIZE				= 16,
+		MAGAZINE_BATCH_SIZE	= MAGAZINE_SIZE / 2
+	};
+
+#endif
+
 #ifdef MEMORYPOOL_STACKTRACE
 
 	#define MEMORYPOOL_STACKTRACE_SIZE				(20)
@@ -190,6 +208,15 @@ DECLARE_PERF_TIMER(MemoryPoolInitFilling)
 #endif
 
 
+#endif
+
+#ifdef MEMORYPOOL_MAGAZINES
+
+	/// the tls slot holding the magazine table (MemoryPoolMagazine*[MAX_MAGAZINE_POOLS]) of each thread
+	static DWORD theMagazineTlsIndex = TLS_OUT_OF_INDEXES;
+	/// the number of pools that have been given a magazine index so far
+	static LONG theMagazinePoolCount = 0;
+
 #endif
 
 static Bool thePreMainInitFlag = false;
@@ -468,6 +495,8 @@ private:
 	MemoryPool							*m_owningPool;				///< the pool that owns this blob
 	MemoryPoolBlob					*m_nextBlob;					///< next blob in this pool
 	MemoryPoolBlob					*m_prevBlob;					///< prev blob in this pool
+	MemoryPoolBlob					*m_nextFreeBlob;			///< next blob in this pool that has free blocks (valid only if this one has any)
+	MemoryPoolBlob					*m_prevFreeBlob;			///< prev blob in this pool that has free blocks (valid only if this one has any)
 	MemoryPoolSingleBlock		*m_firstFreeBlock;		///< ptr to first available block in this blob
 	Int											m_usedBlocksInBlob;		///< total allocated blocks in this blob
 	Int											m_totalBlocksInBlob;	///< total blocks in this blob (allocated + available)
@@ -483,6 +512,9 @@ public:
 	void addBlobToList(MemoryPoolBlob **ppHead, MemoryPoolBlob **ppTail);
 	void removeBlobFromList(MemoryPoolBlob **ppHead, MemoryPoolBlob **ppTail);
 	MemoryPoolBlob *getNextInList();
+	void addBlobToFreeList(MemoryPoolBlob **ppHead);
+	void removeBlobFromFreeList(MemoryPoolBlob **ppHead);
+	MemoryPoolBlob *getNextInFreeList();
 	Bool hasAnyFreeBlocks();
 
 	MemoryPoolSingleBlock *allocateSingleBlock(DECLARE_LITERALSTRING_ARG1);
@@ -504,6 +536,20 @@ public:
 
 };
 
+#ifdef MEMORYPOOL_MAGAZINES
+// ----------------------------------------------------------------------------
+/**
+	the free blocks of one pool that are cached by one thread. the blocks are still
+	counted as used by their blobs and pool until they are handed back.
+*/
+struct MemoryPoolMagazine
+{
+	UnsignedInt							m_epoch;									///< the m_magazineEpoch of the pool when the blocks were taken
+	Int											m_count;									///< number of blocks in m_blocks
+	MemoryPoolSingleBlock		*m_blocks[MAGAZINE_SIZE];	///< the cached blocks; the last one is handed out first
+};
+#endif
+
 // ----------------------------------------------------------------------------
 // PUBLIC DATA
 // ----------------------------------------------------------------------------
@@ -705,6 +751,8 @@ inline void MemoryPoolSingleBlock::debugResetCheckpoint()
 // ----------------------------------------------------------------------------
 /// accessor
 inline MemoryPoolBlob *MemoryPoolBlob::getNextInList() { return m_nextBlob; }
+
+inline MemoryPoolBlob *MemoryPoolBlob::getNextInFreeList() { return m_nextFreeBlob; }
 /// accessor
 inline Bool MemoryPoolBlob::hasAnyFreeBlocks() { return m_firstFreeBlock != NULL; }
 /// accessor
@@ -1155,6 +1203,8 @@ MemoryPoolBlob::MemoryPoolBlob() :
 	m_owningPool(NULL),
 	m_nextBlob(NULL),
 	m_prevBlob(NULL),
+	m_nextFreeBlob(NULL),
+	m_prevFreeBlob(NULL),
 	m_firstFreeBlock(NULL),
 	m_usedBlocksInBlob(0),
 	m_totalBlocksInBlob(0),
@@ -1246,6 +1296,39 @@ void MemoryPoolBlob::removeBlobFromList(MemoryPoolBlob **ppHead, MemoryPoolBlob
 		this->m_nextBlob->m_prevBlob = this->m_prevBlob;
 }
 
+//-----------------------------------------------------------------------------
+/**
+	add this blob to the head of a given pool's list-of-blobs-with-free-blocks
+*/
+void MemoryPoolBlob::addBlobToFreeList(MemoryPoolBlob **ppHead)
+{
+	m_prevFreeBlob = NULL;
+	m_nextFreeBlob = *ppHead;
+
+	if (*ppHead != NULL)
+		(*ppHead)->m_prevFreeBlob = this;
+
+	*ppHead = this;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	remove this blob from a given pool's list-of-blobs-with-free-blocks
+*/
+void MemoryPoolBlob::removeBlobFromFreeList(MemoryPoolBlob **ppHead)
+{
+	if (*ppHead == this)
+		*ppHead = this->m_nextFreeBlob;
+	else
+		this->m_prevFreeBlob->m_nextFreeBlob = this->m_nextFreeBlob;
+
+	if (this->m_nextFreeBlob != NULL)
+		this->m_nextFreeBlob->m_prevFreeBlob = this->m_prevFreeBlob;
+
+	m_nextFreeBlob = NULL;
+	m_prevFreeBlob = NULL;
+}
+
 //-----------------------------------------------------------------------------
 /**
 	grab a free block from this blob, mark it as taken, and return it.
@@ -1508,6 +1591,10 @@ MemoryPool::MemoryPool() :
 	m_firstBlob(NULL),
 	m_lastBlob(NULL),
 	m_firstBlobWithFreeBlocks(NULL)
+#ifdef MEMORYPOOL_MAGAZINES
+	, m_magazineIndex(-1)
+	, m_magazineEpoch(0)
+#endif
 {
 }
 
@@ -1530,6 +1617,15 @@ void MemoryPool::init(MemoryPoolFactory *factory, const char *poolName, Int allo
 	m_lastBlob = NULL;
 	m_firstBlobWithFreeBlocks = NULL;
 
+#ifdef MEMORYPOOL_MAGAZINES
+	// reset() calls us again, but the pool keeps its slot in the magazine tables.
+	if (m_magazineIndex < 0)
+	{
+		Int index = InterlockedIncrement(&theMagazinePoolCount) - 1;
+		m_magazineIndex = index < MAX_MAGAZINE_POOLS ? index : -1;
+	}
+#endif
+
 	// go ahead and init the initial block here (will throw on failure)
 	createBlob(m_initialAllocationCount);
 }
@@ -1563,9 +1659,7 @@ MemoryPoolBlob* MemoryPool::createBlob(Int allocationCount)
 	blob->initBlob(this, allocationCount);	// will throw on failure
 
 	blob->addBlobToList(&m_firstBlob, &m_lastBlob);
-
-	DEBUG_ASSERTCRASH(m_firstBlobWithFreeBlocks == NULL, ("DO NOT IGNORE. Please call John McD - x36872 (m_firstBlobWithFreeBlocks != NULL)"));
-	m_firstBlobWithFreeBlocks = blob;
+	blob->addBlobToFreeList(&m_firstBlobWithFreeBlocks);
 
 	// bookkeeping
 	m_totalBlocksInPool += allocationCount;
@@ -1595,13 +1689,10 @@ Int MemoryPool::freeBlob(MemoryPoolBlob* blob)
 	// this is really just an estimate... will be too small in debug mode.
 	Int amtFreed = totalBlocksInBlob * getAllocationSize() + sizeof(MemoryPoolBlob);
 
-	// de-link it from our list
+	// de-link it from our lists
 	blob->removeBlobFromList(&m_firstBlob, &m_lastBlob);
-
-	// ensure that the 'first free' blob is still a valid blob.
-	// (doesn't need to actually have free blocks, just be a valid blob)
-	if (m_firstBlobWithFreeBlocks == blob)
-		m_firstBlobWithFreeBlocks = m_firstBlob;
+	if (blob->hasAnyFreeBlocks())
+		blob->removeBlobFromFreeList(&m_firstBlobWithFreeBlocks);
 
 	// this is evil... since there is no 'placement delete' we must do this the hard way
 	// and call the dtor directly. ordinarily this is heinous, but in this case we'll
@@ -1622,32 +1713,15 @@ Int MemoryPool::freeBlob(MemoryPoolBlob* blob)
 
 //-----------------------------------------------------------------------------
 /**
-	allocate a block from this pool and return it, but don't bother zeroing
-	out the block. if unable to allocate, throw ERROR_OUT_OF_MEMORY. this
-	function will never return null.
+	take a block from the blobs of this pool, growing the pool if necessary. if unable
+	to allocate, throw ERROR_OUT_OF_MEMORY. the caller must hold TheMemoryPoolCriticalSection.
 */
-void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG1)
+MemoryPoolSingleBlock* MemoryPool::allocateSingleBlockFromBlobs(DECLARE_LITERALSTRING_ARG1)
 {
-	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+	// TheSuperHackers @performance The blobs with free blocks are kept in their own list,
+	// so a full pool no longer walks all of its blobs to find one.
 
-	if (m_firstBlobWithFreeBlocks != NULL && !m_firstBlobWithFreeBlocks->hasAnyFreeBlocks())
-	{
-		// hmm... the current 'free' blob has nothing available. look and see if there
-		// are any other existing blobs with freespace.
-		MemoryPoolBlob *blob = m_firstBlob;
-		for (; blob != NULL; blob = blob->getNextInList())
-		{
-			if (blob->hasAnyFreeBlocks())
-			 	break;
-		}
-
-		// note that if we walk thru the list without finding anything, this will
-		// reset m_firstBlobWithFreeBlocks to null and fall thru.
-	 	m_firstBlobWithFreeBlocks = blob;
-	}
-
-	// OK, if we are here then we have no blobs with freespace... darn.
-	// allocate an overflow block.
+	// if we have no blobs with freespace... darn. allocate an overflow block.
 	if (m_firstBlobWithFreeBlocks == NULL)
 	{
 		if (m_overflowAllocationCount == 0)
@@ -1667,6 +1741,9 @@ void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG
 	MemoryPoolSingleBlock *block = blob->allocateSingleBlock(PASS_LITERALSTRING_ARG1);
 	DEBUG_ASSERTCRASH(block, ("should not fail here"));
 
+	if (!blob->hasAnyFreeBlocks())
+		blob->removeBlobFromFreeList(&m_firstBlobWithFreeBlocks);
+
 #ifdef MEMORYPOOL_CHECKPOINTING
 	BlockCheckpointInfo *bi = debugAddCheckpointInfo(block->debugGetLiteralTagString(), m_factory->getCurCheckpoint(), getAllocationSize());
 	if (bi)
@@ -1680,42 +1757,18 @@ void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG
 
 #ifdef MEMORYPOOL_DEBUG
 	m_factory->adjustTotals(debugLiteralTagString, 1*getAllocationSize(), 0);
-	#ifdef USE_FILLER_VALUE
-	{
-		USE_PERF_TIMER(MemoryPoolInitFilling)
-		::memset32(block->getUserData(), s_initFillerValue, getAllocationSize());
-	}
-	#endif
 #endif
 
-	return block->getUserData();
-}
-
-//-----------------------------------------------------------------------------
-/**
-	allocate a block from this pool and return it, and zero out the contents
-	of the block. if unable to allocate, throw ERROR_OUT_OF_MEMORY. this
-	function will never return null.
-*/
-void* MemoryPool::allocateBlockImplementation(DECLARE_LITERALSTRING_ARG1)
-{
-	void* p = allocateBlockDoNotZeroImplementation(PASS_LITERALSTRING_ARG1);	// throws on failure
-	memset(p, 0, getAllocationSize());
-	return p;
+	return block;
 }
 
 //-----------------------------------------------------------------------------
 /**
-	free a block allocated by this pool. it's ok to pass null.
+	give a block back to the blob it came from. the caller must hold
+	TheMemoryPoolCriticalSection.
 */
-void MemoryPool::freeBlock(void* pBlockPtr)
+void MemoryPool::freeSingleBlockToBlobs(MemoryPoolSingleBlock *block)
 {
-	if (!pBlockPtr)
-		return;	// my, that was easy
-
-	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
-
-	MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
 	MemoryPoolBlob *blob = block->getOwningBlob();
 #ifdef MEMORYPOOL_DEBUG
 	const char* tagString = block->debugGetLiteralTagString();
@@ -1730,6 +1783,8 @@ void MemoryPool::freeBlock(void* pBlockPtr)
 		bi->debugSetFreepoint(m_factory->getCurCheckpoint());
 #endif
 
+	const Bool wasFull = !blob->hasAnyFreeBlocks();
+
 	blob->freeSingleBlock(block);
 
 	// if we want to free the blobs as they become empty, do that here.
@@ -1741,8 +1796,8 @@ void MemoryPool::freeBlock(void* pBlockPtr)
 	//	return;
 	//}
 
-	if (!m_firstBlobWithFreeBlocks)
-		m_firstBlobWithFreeBlocks = blob;
+	if (wasFull)
+		blob->addBlobToFreeList(&m_firstBlobWithFreeBlocks);
 
 	// bookkeeping
 	--m_usedBlocksInPool;
@@ -1752,6 +1807,173 @@ void MemoryPool::freeBlock(void* pBlockPtr)
 #endif
 }
 
+#ifdef MEMORYPOOL_MAGAZINES
+//-----------------------------------------------------------------------------
+/**
+	return the magazine of the calling thread for this pool, creating it if necessary.
+	returns null if this pool has no magazines.
+*/
+MemoryPoolMagazine* MemoryPool::getThreadMagazine()
+{
+	if (m_magazineIndex < 0 || theMagazineTlsIndex == TLS_OUT_OF_INDEXES)
+		return NULL;
+
+	MemoryPoolMagazine **magazines = (MemoryPoolMagazine **)::TlsGetValue(theMagazineTlsIndex);
+	if (magazines == NULL)
+	{
+		magazines = (MemoryPoolMagazine **)::sysAllocateDoNotZero(MAX_MAGAZINE_POOLS * sizeof(MemoryPoolMagazine *));	// will throw on failure
+		memset(magazines, 0, MAX_MAGAZINE_POOLS * sizeof(MemoryPoolMagazine *));
+		::TlsSetValue(theMagazineTlsIndex, magazines);
+	}
+
+	MemoryPoolMagazine *magazine = magazines[m_magazineIndex];
+	if (magazine == NULL)
+	{
+		magazine = (MemoryPoolMagazine *)::sysAllocateDoNotZero(sizeof(MemoryPoolMagazine));	// will throw on failure
+		magazine->m_epoch = m_magazineEpoch;
+		magazine->m_count = 0;
+		magazines[m_magazineIndex] = magazine;
+	}
+	else if (magazine->m_epoch != m_magazineEpoch)
+	{
+		// the pool was reset since, so the blocks are gone with their blobs.
+		magazine->m_epoch = m_magazineEpoch;
+		magazine->m_count = 0;
+	}
+
+	return magazine;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	take a batch of blocks from the blobs into the given (empty) magazine. only the
+	first block may grow the pool; the rest are taken while any blob has free blocks.
+	throws ERROR_OUT_OF_MEMORY on failure.
+*/
+void MemoryPool::refillMagazine(MemoryPoolMagazine *magazine)
+{
+	DEBUG_ASSERTCRASH(magazine->m_count == 0, ("refilling a nonempty magazine"));
+
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	magazine->m_blocks[magazine->m_count++] = allocateSingleBlockFromBlobs();	// throws on failure
+
+	while (magazine->m_count < MAGAZINE_BATCH_SIZE && m_firstBlobWithFreeBlocks != NULL)
+		magazine->m_blocks[magazine->m_count++] = allocateSingleBlockFromBlobs();
+}
+
+//-----------------------------------------------------------------------------
+/**
+	give the blocks of the given magazine back to the blobs, until only keepCount are left.
+*/
+void MemoryPool::drainMagazine(MemoryPoolMagazine *magazine, Int keepCount)
+{
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	while (magazine->m_count > keepCount)
+		freeSingleBlockToBlobs(magazine->m_blocks[--magazine->m_count]);
+}
+
+//-----------------------------------------------------------------------------
+/**
+	give all blocks that the calling thread caches for this pool back to the blobs.
+*/
+void MemoryPool::drainThreadMagazine()
+{
+	if (m_magazineIndex < 0 || theMagazineTlsIndex == TLS_OUT_OF_INDEXES)
+		return;
+
+	// don't create a magazine just to find it empty.
+	MemoryPoolMagazine **magazines = (MemoryPoolMagazine **)::TlsGetValue(theMagazineTlsIndex);
+	if (magazines == NULL)
+		return;
+
+	MemoryPoolMagazine *magazine = magazines[m_magazineIndex];
+	if (magazine != NULL && magazine->m_epoch == m_magazineEpoch && magazine->m_count > 0)
+		drainMagazine(magazine, 0);
+}
+#endif // MEMORYPOOL_MAGAZINES
+
+//-----------------------------------------------------------------------------
+/**
+	allocate a block from this pool and return it, but don't bother zeroing
+	out the block. if unable to allocate, throw ERROR_OUT_OF_MEMORY. this
+	function will never return null.
+*/
+void* MemoryPool::allocateBlockDoNotZeroImplementation(DECLARE_LITERALSTRING_ARG1)
+{
+#ifdef MEMORYPOOL_MAGAZINES
+	MemoryPoolMagazine *magazine = getThreadMagazine();
+	if (magazine != NULL)
+	{
+		if (magazine->m_count == 0)
+			refillMagazine(magazine);	// throws on failure
+
+		return magazine->m_blocks[--magazine->m_count]->getUserData();
+	}
+#endif
+
+	MemoryPoolSingleBlock *block;
+	{
+		ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+		block = allocateSingleBlockFromBlobs(PASS_LITERALSTRING_ARG1);	// throws on failure
+	}
+
+#ifdef MEMORYPOOL_DEBUG
+	#ifdef USE_FILLER_VALUE
+	{
+		USE_PERF_TIMER(MemoryPoolInitFilling)
+		::memset32(block->getUserData(), s_initFillerValue, getAllocationSize());
+	}
+	#endif
+#endif
+
+	return block->getUserData();
+}
+
+//-----------------------------------------------------------------------------
+/**
+	allocate a block from this pool and return it, and zero out the contents
+	of the block. if unable to allocate, throw ERROR_OUT_OF_MEMORY. this
+	function will never return null.
+*/
+void* MemoryPool::allocateBlockImplementation(DECLARE_LITERALSTRING_ARG1)
+{
+	void* p = allocateBlockDoNotZeroImplementation(PASS_LITERALSTRING_ARG1);	// throws on failure
+	memset(p, 0, getAllocationSize());
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	free a block allocated by this pool. it's ok to pass null.
+*/
+void MemoryPool::freeBlock(void* pBlockPtr)
+{
+	if (!pBlockPtr)
+		return;	// my, that was easy
+
+	MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
+
+#ifdef MEMORYPOOL_MAGAZINES
+	MemoryPoolMagazine *magazine = getThreadMagazine();
+	if (magazine != NULL)
+	{
+		DEBUG_ASSERTCRASH(block->getOwningBlob() && block->getOwningBlob()->getOwningPool() == this, ("block does not belong to this pool"));
+
+		if (magazine->m_count == MAGAZINE_SIZE)
+			drainMagazine(magazine, MAGAZINE_SIZE - MAGAZINE_BATCH_SIZE);
+
+		magazine->m_blocks[magazine->m_count++] = block;
+		return;
+	}
+#endif
+
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	freeSingleBlockToBlobs(block);
+}
+
 //-----------------------------------------------------------------------------
 Int MemoryPool::countBlobsInPool()
 {
@@ -1793,6 +2015,13 @@ Int MemoryPool::releaseEmpties()
 */
 void MemoryPool::reset()
 {
+#ifdef MEMORYPOOL_MAGAZINES
+	// the blocks cached by our own thread can go back; those of other threads are
+	// thrown away with their blobs, and the new epoch tells their magazines so.
+	drainThreadMagazine();
+	++m_magazineEpoch;
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
 
 	// toss everything. we could do this slightly more efficiently,
@@ -1809,6 +2038,18 @@ void MemoryPool::reset()
 
 }
 
+//-----------------------------------------------------------------------------
+/**
+	grow the pool with a single blob so that it has at least the given number of blocks.
+*/
+void MemoryPool::reserveBlocks(Int count)
+{
+	ScopedCriticalSection scopedCriticalSection(TheMemoryPoolCriticalSection);
+
+	if (m_totalBlocksInPool < count)
+		createBlob(::roundUpMemBound(count - m_totalBlocksInPool));	// will throw on failure
+}
+
 //-----------------------------------------------------------------------------
 /**
 	add this pool to the factory's list-of-pools.
@@ -1905,14 +2146,26 @@ void MemoryPool::debugMemoryVerifyPool()
 
 	Int used = 0;
 	Int total = 0;
-	for (MemoryPoolBlob* blob = m_firstBlob; blob; blob = blob->getNextInList())
+	Int blobsWithFreeBlocks = 0;
+	MemoryPoolBlob* blob;
+	for (blob = m_firstBlob; blob; blob = blob->getNextInList())
 	{
 		blob->debugMemoryVerifyBlob();
 		used += blob->getUsedBlockCount();
 		total += blob->getTotalBlockCount();
+		if (blob->hasAnyFreeBlocks())
+			++blobsWithFreeBlocks;
 	}
 	DEBUG_ASSERTCRASH(m_usedBlocksInPool == used, ("used mismatch %d %d",m_usedBlocksInPool,used));
 	DEBUG_ASSERTCRASH(m_totalBlocksInPool == total, ("total mismatch %d %d",m_totalBlocksInPool,total));
+
+	Int freeListBlobs = 0;
+	for (blob = m_firstBlobWithFreeBlocks; blob; blob = blob->getNextInFreeList())
+	{
+		DEBUG_ASSERTCRASH(blob->hasAnyFreeBlocks(), ("full blob in the list of blobs with free blocks"));
+		++freeListBlobs;
+	}
+	DEBUG_ASSERTCRASH(blobsWithFreeBlocks == freeListBlobs, ("free blob mismatch %d %d",blobsWithFreeBlocks,freeListBlobs));
 }
 #endif
 
@@ -2161,6 +2414,17 @@ void DynamicMemoryAllocator::debugIgnoreLeaksForThisBlock(void* pBlockPtr)
 */
 void *DynamicMemoryAllocator::allocateBytesDoNotZeroImplementation(Int numBytes DECLARE_LITERALSTRING_ARG2)
 {
+#ifdef MEMORYPOOL_MAGAZINES
+	// the subpools are thread safe by themselves, so only the raw blocks need the lock.
+	MemoryPool *subPool = findPoolForSize(numBytes);
+	if (subPool != NULL)
+	{
+		void *subPoolResult = subPool->allocateBlockDoNotZeroImplementation();	// throws on failure
+		InterlockedIncrement((LONG *)&m_usedBlocksInDma);
+		return subPoolResult;
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheDmaCriticalSection);
 
 	void *result = NULL;
@@ -2235,7 +2499,7 @@ void *DynamicMemoryAllocator::allocateBytesDoNotZeroImplementation(Int numBytes
 }
 #endif // MEMORYPOOL_DEBUG
 
-	++m_usedBlocksInDma;
+	InterlockedIncrement((LONG *)&m_usedBlocksInDma);
 	DEBUG_ASSERTCRASH(m_usedBlocksInDma >= 0, ("negative count for m_usedBlocksInDma"));
 #ifdef MEMORYPOOL_DEBUG
 	#ifdef USE_FILLER_VALUE
@@ -2277,13 +2541,23 @@ void DynamicMemoryAllocator::freeBytes(void* pBlockPtr)
 	if (!pBlockPtr)
 		return;
 
+	MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
+
+#ifdef MEMORYPOOL_MAGAZINES
+	// the subpools are thread safe by themselves, so only the raw blocks need the lock.
+	if (block->getOwningBlob())
+	{
+		block->getOwningBlob()->getOwningPool()->freeBlock(pBlockPtr);
+		InterlockedDecrement((LONG *)&m_usedBlocksInDma);
+		return;
+	}
+#endif
+
 	ScopedCriticalSection scopedCriticalSection(TheDmaCriticalSection);
 
 #ifdef MEMORYPOOL_CHECK_BLOCK_OWNERSHIP
 	DEBUG_ASSERTCRASH(debugIsBlockInDma(pBlockPtr), ("block is not in this dma"));
 #endif
-
-	MemoryPoolSingleBlock *block = MemoryPoolSingleBlock::recoverBlockFromUserData(pBlockPtr);
 #ifdef MEMORYPOOL_DEBUG
 	Int waste = 0, used = 0;
 #ifdef INTENSE_DMA_BOOKKEEPING
@@ -2344,7 +2618,7 @@ void DynamicMemoryAllocator::freeBytes(void* pBlockPtr)
 		::sysFree((void *)block);
 
 	}
-	--m_usedBlocksInDma;
+	InterlockedDecrement((LONG *)&m_usedBlocksInDma);
 	DEBUG_ASSERTCRASH(m_usedBlocksInDma >= 0, ("negative count for m_usedBlocksInDma"));
 
 #ifdef INTENSE_DMA_BOOKKEEPING
@@ -2613,7 +2887,10 @@ MemoryPoolFactory::MemoryPoolFactory() :
 */
 void MemoryPoolFactory::init()
 {
-	// my, that was easy
+#ifdef MEMORYPOOL_MAGAZINES
+	if (theMagazineTlsIndex == TLS_OUT_OF_INDEXES)
+		theMagazineTlsIndex = ::TlsAlloc();	// pools simply go without magazines if this fails
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -2631,6 +2908,24 @@ MemoryPoolFactory::~MemoryPoolFactory()
 	{
 		destroyDynamicMemoryAllocator(m_firstDmaInFactory);
 	}
+
+#ifdef MEMORYPOOL_MAGAZINES
+	// the pools have taken back the blocks of this thread; the magazines of other
+	// threads are simply abandoned.
+	if (theMagazineTlsIndex != TLS_OUT_OF_INDEXES)
+	{
+		MemoryPoolMagazine **magazines = (MemoryPoolMagazine **)::TlsGetValue(theMagazineTlsIndex);
+		if (magazines != NULL)
+		{
+			for (Int i = 0; i < MAX_MAGAZINE_POOLS; ++i)
+				::sysFree(magazines[i]);
+			::sysFree(magazines);
+		}
+		::TlsFree(theMagazineTlsIndex);
+		theMagazineTlsIndex = TLS_OUT_OF_INDEXES;
+	}
+	theMagazinePoolCount = 0;
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -2699,6 +2994,10 @@ void MemoryPoolFactory::destroyMemoryPool(MemoryPool *pMemoryPool)
 	if (!pMemoryPool)
 		return;
 
+#ifdef MEMORYPOOL_MAGAZINES
+	pMemoryPool->drainThreadMagazine();
+#endif
+
 	DEBUG_ASSERTCRASH(pMemoryPool->getUsedBlockCount() == 0, ("destroying a nonempty pool"));
 
 	pMemoryPool->removeFromList(&m_firstPoolInFactory);
@@ -2963,6 +3262,105 @@ void MemoryPoolFactory::debugResetCheckpoints()
 }
 #endif
 
+//-----------------------------------------------------------------------------
+/**
+	give the blocks in the magazines of the calling thread back to their pools and free
+	the magazines. blocks cached by a thread that exits without this are lost for good.
+*/
+void MemoryPoolFactory::releaseThreadMagazines()
+{
+#ifdef MEMORYPOOL_MAGAZINES
+	if (theMagazineTlsIndex == TLS_OUT_OF_INDEXES)
+		return;
+
+	MemoryPoolMagazine **magazines = (MemoryPoolMagazine **)::TlsGetValue(theMagazineTlsIndex);
+	if (magazines == NULL)
+		return;
+
+	for (MemoryPool *pool = m_firstPoolInFactory; pool; pool = pool->getNextPoolInList())
+		pool->drainThreadMagazine();
+
+	::TlsSetValue(theMagazineTlsIndex, NULL);
+	for (Int i = 0; i < MAX_MAGAZINE_POOLS; ++i)
+		::sysFree(magazines[i]);
+	::sysFree(magazines);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+/**
+	churn the blocks of every pool created so far. each pool is grown to several times its
+	initial count, then every other block is freed and allocated again for a number of rounds,
+	which leaves many blobs partially free. the blocks are not touched, so only the pool
+	bookkeeping is measured.
+*/
+Int MemoryPoolFactory::memoryPoolBenchmark()
+{
+	const Int MIN_BLOCKS = 256;
+	const Int MAX_BLOCKS = 65536;
+	const Int ROUNDS = 16;
+
+	Int64 ticksPerSecond;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&ticksPerSecond);
+	const double msPerTick = 1000.0 / (double)ticksPerSecond;
+
+	void **blocks = (void **)::sysAllocateDoNotZero(MAX_BLOCKS * sizeof(void *));	// will throw on failure
+	double totalMs = 0.0;
+	Int totalOperations = 0;
+
+	// Note that we use printf here because this is run from cmd.
+	for (MemoryPool *pool = m_firstPoolInFactory; pool; pool = pool->getNextPoolInList())
+	{
+		Int count = pool->getInitialBlockCount() * 4;
+		if (count < MIN_BLOCKS)
+			count = MIN_BLOCKS;
+		if (count > MAX_BLOCKS)
+			count = MAX_BLOCKS;
+		if (pool->getOverflowBlockCount() == 0 && count > pool->getFreeBlockCount())
+			count = pool->getFreeBlockCount();	// this pool may not grow
+		if (count < 2)
+			continue;
+
+		Int64 startTicks;
+		QueryPerformanceCounter((LARGE_INTEGER *)&startTicks);
+
+		Int i;
+		for (i = 0; i < count; ++i)
+			blocks[i] = pool->allocateBlockDoNotZero("memoryPoolBenchmark");
+
+		const Int blobs = pool->countBlobsInPool();
+
+		for (Int round = 0; round < ROUNDS; ++round)
+		{
+			for (i = round & 1; i < count; i += 2)
+				pool->freeBlock(blocks[i]);
+			for (i = round & 1; i < count; i += 2)
+				blocks[i] = pool->allocateBlockDoNotZero("memoryPoolBenchmark");
+		}
+
+		for (i = 0; i < count; ++i)
+			pool->freeBlock(blocks[i]);
+
+		Int64 endTicks;
+		QueryPerformanceCounter((LARGE_INTEGER *)&endTicks);
+
+		const double ms = (double)(endTicks - startTicks) * msPerTick;
+		const Int operations = count * 2 + (count / 2) * 2 * ROUNDS;
+		totalMs += ms;
+		totalOperations += operations;
+
+		printf("%-40s %6d bytes %6d blocks %4d blobs %9.3f ms %7.1f ns/op\n",
+			pool->getPoolName(), pool->getAllocationSize(), count, blobs, ms, ms * 1000000.0 / operations);
+	}
+
+	printf("Memory pool benchmark: %d operations, %.3f ms, %.1f ns/op\n",
+		totalOperations, totalMs, totalOperations > 0 ? totalMs * 1000000.0 / totalOperations : 0.0);
+	fflush(stdout);
+
+	::sysFree(blocks);
+	return 0;
+}
+
 //-----------------------------------------------------------------------------
 void MemoryPoolFactory::memoryPoolUsageReport( const char* filename, FILE *appendToFileInstead )
 {
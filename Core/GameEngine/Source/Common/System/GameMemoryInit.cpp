@@ -101,6 +101,52 @@ static Int roundUpMemBound(Int i)
 		return (i + (MEM_BOUND_ALIGNMENT-1)) & ~(MEM_BOUND_ALIGNMENT-1);
 }
 
+//-----------------------------------------------------------------------------
+/**
+	read lines of "poolName initialCount overflowCount" into PoolSizes; lines that start with
+	';' are comments. if growExistingPools is set, the pools that exist already are grown to
+	the initial count too.
+*/
+static void readPoolSizes(FILE* fp, Bool growExistingPools)
+{
+	char buf[_MAX_PATH];
+	char poolName[256];
+	int initial, overflow;
+	while (fgets(buf, _MAX_PATH, fp))
+	{
+		if (buf[0] == ';')
+			continue;
+		if (sscanf(buf, "%255s %d %d", poolName, &initial, &overflow ) == 3)
+		{
+			// currently, these must be multiples of 4. so round up.
+			initial = roundUpMemBound(initial);
+			overflow = roundUpMemBound(overflow);
+
+			for (PoolSizeRec* p = PoolSizes; p->name != NULL; ++p)
+			{
+				if (stricmp(p->name, poolName) == 0)
+				{
+					p->initial = initial;
+					p->overflow = overflow;
+					break;	// from for-p
+				}
+			}
+
+			if (growExistingPools)
+			{
+				for (MemoryPool* pool = TheMemoryPoolFactory->getFirstMemoryPool(); pool != NULL; pool = pool->getNextPoolInList())
+				{
+					if (stricmp(pool->getPoolName(), poolName) == 0)
+					{
+						pool->reserveBlocks(initial);	// will throw on failure
+						break;	// from for-pool
+					}
+				}
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 void userMemoryManagerInitPools()
 {
@@ -128,27 +174,80 @@ void userMemoryManagerInitPools()
 	FILE* fp = fopen(buf, "r");
 	if (fp)
 	{
-		char poolName[256];
-		int initial, overflow;
+		readPoolSizes(fp, false);
+		fclose(fp);
+	}
+}
+
+//-----------------------------------------------------------------------------
+Bool userMemoryManagerReadPoolProfile(const char *filename)
+{
+	FILE* fp = fopen(filename, "r");
+	if (fp == NULL)
+		return false;
+
+	readPoolSizes(fp, true);
+	fclose(fp);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+struct PoolPeakRec
+{
+	char name[256];
+	Int peak;
+	Int overflow;
+	Bool written;
+};
+
+//-----------------------------------------------------------------------------
+Bool userMemoryManagerWritePoolProfile(const char *filename)
+{
+	// keep the higher peaks of the earlier runs, and the pools that this run didn't create.
+	std::vector<PoolPeakRec> earlierPeaks;
+	FILE* fp = fopen(filename, "r");
+	if (fp)
+	{
+		char buf[_MAX_PATH];
+		PoolPeakRec rec;
+		rec.written = false;
 		while (fgets(buf, _MAX_PATH, fp))
 		{
-			if (buf[0] == ';')
-				continue;
-			if (sscanf(buf, "%s %d %d", poolName, &initial, &overflow ) == 3)
+			if (buf[0] != ';' && sscanf(buf, "%255s %d %d", rec.name, &rec.peak, &rec.overflow) == 3)
+				earlierPeaks.push_back(rec);
+		}
+		fclose(fp);
+	}
+
+	fp = fopen(filename, "w");
+	if (fp == NULL)
+		return false;
+
+	fprintf(fp, "; Memory pool profile: peak block count and overflow count of every pool\n");
+
+	for (MemoryPool* pool = TheMemoryPoolFactory->getFirstMemoryPool(); pool != NULL; pool = pool->getNextPoolInList())
+	{
+		Int peak = pool->getPeakBlockCount();
+		for (size_t i = 0; i < earlierPeaks.size(); ++i)
+		{
+			if (stricmp(earlierPeaks[i].name, pool->getPoolName()) == 0)
 			{
-				for (PoolSizeRec* p = PoolSizes; p->name != NULL; ++p)
-				{
-					if (stricmp(p->name, poolName) == 0)
-					{
-						// currently, these must be multiples of 4. so round up.
-						p->initial = roundUpMemBound(initial);
-						p->overflow = roundUpMemBound(overflow);
-						break;	// from for-p
-					}
-				}
+				if (peak < earlierPeaks[i].peak)
+					peak = earlierPeaks[i].peak;
+				earlierPeaks[i].written = true;
+				break;
 			}
 		}
-		fclose(fp);
+		fprintf(fp, "%s %d %d\n", pool->getPoolName(), peak, pool->getOverflowBlockCount());
 	}
+
+	for (size_t i = 0; i < earlierPeaks.size(); ++i)
+	{
+		if (!earlierPeaks[i].written)
+			fprintf(fp, "%s %d %d\n", earlierPeaks[i].name, earlierPeaks[i].peak, earlierPeaks[i].overflow);
+	}
+
+	fclose(fp);
+	return true;
 }
 
@@ -89,6 +89,16 @@ void MemoryPoolFactory::memoryPoolUsageReport( const char* filename, FILE *appen
 {
 }
 
+Int MemoryPoolFactory::memoryPoolBenchmark()
+{
+	printf("The memory pools are disabled in this build\n");
+	return 1;
+}
+
+void MemoryPoolFactory::releaseThreadMagazines()
+{
+}
+
 #ifdef MEMORYPOOL_DEBUG
 void MemoryPoolFactory::debugMemoryReport(Int flags, Int startCheckpoint, Int endCheckpoint, FILE *fp )
 {
@@ -155,6 +165,16 @@ void shutdownMemoryManager()
 	DEBUG_SHUTDOWN();
 }
 
+Bool userMemoryManagerReadPoolProfile(const char *filename)
+{
+	return false;
+}
+
+Bool userMemoryManagerWritePoolProfile(const char *filename)
+{
+	return false;
+}
+
 
 #ifndef DISABLE_GAMEMEMORY_NEW_OPERATORS
 
@@ -108,8 +108,9 @@ RAMFile::RAMFile()
 	m_data(NULL),
 //Added By Sadullah Nader
 //Initializtion(s) inserted
-	m_pos(0)
+	m_pos(0),
 //
+	m_ownsData(TRUE)
 {
 
 }
@@ -182,6 +183,7 @@ Bool RAMFile::open( File *file )
 	// read whole file in to memory
 	m_size = file->size();
 	m_data = MSGNEW("RAMFILE") char [ m_size ];	// pool[]ify
+	m_ownsData = TRUE;
 
 	if ( m_data == NULL )
 	{
@@ -216,11 +218,9 @@ Bool RAMFile::openFromArchive(File *archiveFile, const AsciiString& filename, In
 		return FALSE;
 	}
 
-	if (m_data != NULL) {
-		delete[] m_data;
-		m_data = NULL;
-	}
+	closeFile();
 	m_data = MSGNEW("RAMFILE") Char [size];	// pool[]ify
+	m_ownsData = TRUE;
 	m_size = size;
 
 	if (archiveFile->seek(offset, File::START) != offset) {
@@ -234,6 +234,36 @@ Bool RAMFile::openFromArchive(File *archiveFile, const AsciiString& filename, In
 	return TRUE;
 }
 
+//============================================================================
+// RAMFile::openFromMemory
+//============================================================================
+/**
+	* Reads the file data in place instead of copying it. The memory is not
+	* freed on close and must stay valid until then, for example the view of
+	* a mapped archive file.
+	*/
+//============================================================================
+Bool RAMFile::openFromMemory(const Char *data, const AsciiString& filename, Int size)
+{
+	if (data == NULL) {
+		return FALSE;
+	}
+
+	if (File::open(filename.str(), File::READ | File::BINARY) == FALSE) {
+		return FALSE;
+	}
+
+	closeFile();
+	// RAMFile never writes to m_data, so it is safe to point it at read only memory.
+	m_data = const_cast<Char *>(data);
+	m_ownsData = FALSE;
+	m_size = size;
+	m_pos = 0;
+	m_nameStr = filename;
+
+	return TRUE;
+}
+
 //=================================================================
 // RAMFile::close
 //=================================================================
@@ -253,8 +283,12 @@ void RAMFile::close( void )
 
 void RAMFile::closeFile()
 {
-	delete [] m_data;
+	if (m_ownsData)
+	{
+		delete [] m_data;
+	}
 	m_data = NULL;
+	m_ownsData = TRUE;
 }
 
 //=================================================================
@@ -564,6 +598,12 @@ char* RAMFile::readEntireAndClose()
 	}
 
 	char* tmp = m_data;
+	if (!m_ownsData)
+	{
+		// The data is not ours to give away, so the caller gets a copy.
+		tmp = MSGNEW("RAMFILE") char [ m_size ];
+		memcpy(tmp, m_data, m_size);
+	}
 	m_data = NULL;	// will belong to our caller!
 
 	close();
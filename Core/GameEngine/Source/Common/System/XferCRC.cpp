@@ -93,15 +93,6 @@ void XferCRC::endBlock( void )
 
 }  // end endBlock
 
-//-------------------------------------------------------------------------------------------------
-//-------------------------------------------------------------------------------------------------
-void XferCRC::addCRC( UnsignedInt val )
-{
-
-	m_crc = (m_crc << 1) + htobe(val) + ((m_crc >> 31) & 0x01);
-
-}  // end addCRC
-
 // ------------------------------------------------------------------------------------------------
 /** Entry point for xfering a snapshot */
 // ------------------------------------------------------------------------------------------------
@@ -130,10 +121,20 @@ void XferCRC::xferImplementation( void *data, Int dataSize )
 
 	int dataBytes = (dataSize / 4);
 
-	for (Int i=0 ; i<dataBytes; ++i)
+	// TheSuperHackers @performance Keep the CRC in a local across the loop and run four words per iteration.
+	UnsignedInt crc = m_crc;
+	for (; dataBytes >= 4; dataBytes -= 4, uintPtr += 4)
+	{
+		crc = ((crc << 1) | (crc >> 31)) + htobe(uintPtr[0]);
+		crc = ((crc << 1) | (crc >> 31)) + htobe(uintPtr[1]);
+		crc = ((crc << 1) | (crc >> 31)) + htobe(uintPtr[2]);
+		crc = ((crc << 1) | (crc >> 31)) + htobe(uintPtr[3]);
+	}
+	for (; dataBytes > 0; --dataBytes, ++uintPtr)
 	{
-		addCRC (*uintPtr++);
+		crc = ((crc << 1) | (crc >> 31)) + htobe(*uintPtr);
 	}
+	m_crc = crc;
 
 	UnsignedInt val = 0;
 	const unsigned char *c = (const unsigned char *)uintPtr;
@@ -156,6 +157,17 @@ void XferCRC::xferImplementation( void *data, Int dataSize )
 
 }  // end xferImplementation
 
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void XferCRC::xferCoord3D( Coord3D *coord3D )
+{
+
+	addCRCData( &coord3D->x, sizeof( Real ) );
+	addCRCData( &coord3D->y, sizeof( Real ) );
+	addCRCData( &coord3D->z, sizeof( Real ) );
+
+}  // end xferCoord3D
+
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 void XferCRC::skip( Int dataSize )
@@ -58,6 +58,9 @@ XferSave::XferSave( void )
 	m_xferMode = XFER_SAVE;
 	m_fileFP = NULL;
 	m_blockStack = NULL;
+	m_buffer = NEW char[ WRITE_BUFFER_SIZE ];
+	m_bufferUsed = 0;
+	m_bufferFilePos = 0;
 
 }  // end XferSave
 
@@ -98,6 +101,8 @@ XferSave::~XferSave( void )
 
 	}  // end if
 
+	delete [] m_buffer;
+
 }  // end ~XferSave
 
 //-------------------------------------------------------------------------------------------------
@@ -129,6 +134,9 @@ void XferSave::open( AsciiString identifier )
 
 	}  // end if
 
+	m_bufferUsed = 0;
+	m_bufferFilePos = 0;
+
 }  // end open
 
 //-------------------------------------------------------------------------------------------------
@@ -146,6 +154,16 @@ void XferSave::close( void )
 
 	}  // end if
 
+	// write what is left in the buffer. The callers do not expect close to throw, so a failure
+	// here is only reported. Callers that need to know call flush before close.
+	if( m_bufferUsed > 0 && fwrite( m_buffer, m_bufferUsed, 1, m_fileFP ) != 1 )
+	{
+
+		DEBUG_CRASH(( "XferSave - Error writing to file '%s'", m_identifier.str() ));
+
+	}  // end if
+	m_bufferUsed = 0;
+
 	// close the file
 	fclose( m_fileFP );
 	m_fileFP = NULL;
@@ -170,18 +188,11 @@ Int XferSave::beginBlock( void )
 										 m_identifier.str()) );
 
 	// get the current file position so we can back up here for the next end block call
-	XferFilePos filePos = ftell( m_fileFP );
+	XferFilePos filePos = m_bufferFilePos + m_bufferUsed;
 
 	// write a placeholder
 	XferBlockSize blockSize = 0;
-	if( fwrite( &blockSize, sizeof( XferBlockSize ), 1, m_fileFP ) != 1 )
-	{
-
-		DEBUG_CRASH(( "XferSave::beginBlock - Error writing block size in '%s'",
-									m_identifier.str() ));
-		return XFER_WRITE_ERROR;
-
-	}  // end if
+	writeData( &blockSize, sizeof( XferBlockSize ) );
 
 	// save this block position on the top of the "stack"
 	XferBlockData *top = newInstance(XferBlockData);
@@ -224,27 +235,41 @@ void XferSave::endBlock( void )
 	}  // end if
 
 	// save our current file position
-	XferFilePos currentFilePos = ftell( m_fileFP );
+	XferFilePos currentFilePos = m_bufferFilePos + m_bufferUsed;
 
 	// pop the block descriptor off the top of the block stack
 	XferBlockData *top = m_blockStack;
 	m_blockStack = m_blockStack->next;
 
-	// rewind the file to the block position
-	fseek( m_fileFP, top->filePos, SEEK_SET );
-
-	// write the size in bytes between the block position and what is our current file position
+	// the size in bytes between the block position and what is our current file position
 	XferBlockSize blockSize = currentFilePos - top->filePos - sizeof( XferBlockSize );
-	if( fwrite( &blockSize, sizeof( XferBlockSize ), 1, m_fileFP ) != 1 )
+
+	if( top->filePos >= m_bufferFilePos )
 	{
 
-		DEBUG_CRASH(( "Error writing block size to file '%s'", m_identifier.str() ));
-		throw XFER_WRITE_ERROR;
+		// the placeholder is still in the buffer
+		memcpy( m_buffer + (top->filePos - m_bufferFilePos), &blockSize, sizeof( XferBlockSize ) );
 
 	}  // end if
+	else
+	{
+
+		// rewind the file to the block position
+		flushBuffer();
+		fseek( m_fileFP, top->filePos, SEEK_SET );
+
+		if( fwrite( &blockSize, sizeof( XferBlockSize ), 1, m_fileFP ) != 1 )
+		{
+
+			DEBUG_CRASH(( "Error writing block size to file '%s'", m_identifier.str() ));
+			throw XFER_WRITE_ERROR;
+
+		}  // end if
+
+		// place the file pointer back to the current position
+		fseek( m_fileFP, currentFilePos, SEEK_SET );
 
-	// place the file pointer back to the current position
-	fseek( m_fileFP, currentFilePos, SEEK_SET );
+	}  // end else
 
 	// delete the block data as it's all used up now
 	deleteInstance(top);
@@ -263,7 +288,9 @@ void XferSave::skip( Int dataSize )
 
 
 	// skip forward dataSize bytes
+	flushBuffer();
 	fseek( m_fileFP, dataSize, SEEK_CUR );
+	m_bufferFilePos += dataSize;
 
 }  // end skip
 
@@ -346,7 +373,61 @@ void XferSave::xferImplementation( void *data, Int dataSize )
 	DEBUG_ASSERTCRASH( m_fileFP != NULL, ("XferSave - file pointer for '%s' is NULL",
 										 m_identifier.str()) );
 
-	// write data to file
+	writeData( data, dataSize );
+
+}  // end xferImplementation
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void XferSave::xferCoord3D( Coord3D *coord3D )
+{
+
+	writeData( &coord3D->x, sizeof( Real ) );
+	writeData( &coord3D->y, sizeof( Real ) );
+	writeData( &coord3D->z, sizeof( Real ) );
+
+}  // end xferCoord3D
+
+//-------------------------------------------------------------------------------------------------
+/** Write the buffer to the file */
+//-------------------------------------------------------------------------------------------------
+void XferSave::flushBuffer( void )
+{
+
+	if( m_bufferUsed == 0 )
+		return;
+
+	if( fwrite( m_buffer, m_bufferUsed, 1, m_fileFP ) != 1 )
+	{
+
+		DEBUG_CRASH(( "XferSave - Error writing to file '%s'", m_identifier.str() ));
+		throw XFER_WRITE_ERROR;
+
+	}  // end if
+
+	m_bufferFilePos += m_bufferUsed;
+	m_bufferUsed = 0;
+
+}  // end flushBuffer
+
+//-------------------------------------------------------------------------------------------------
+/** Write the buffer to the file to make room for data. Data that does not fit into the empty
+	* buffer is written to the file directly */
+//-------------------------------------------------------------------------------------------------
+void XferSave::writeDataAfterFlush( const void *data, Int dataSize )
+{
+
+	flushBuffer();
+
+	if( dataSize <= WRITE_BUFFER_SIZE )
+	{
+
+		memcpy( m_buffer, data, dataSize );
+		m_bufferUsed = dataSize;
+		return;
+
+	}  // end if
+
 	if( fwrite( data, dataSize, 1, m_fileFP ) != 1 )
 	{
 
@@ -355,4 +436,6 @@ void XferSave::xferImplementation( void *data, Int dataSize )
 
 	}  // end if
 
-}  // end xferImplementation
+	m_bufferFilePos += dataSize;
+
+}  // end writeDataAfterFlush
@@ -69,12 +69,13 @@ WorkerProcess::WorkerProcess()
 {
 	m_processHandle = NULL;
 	m_readHandle = NULL;
+	m_writeHandle = NULL;
 	m_jobHandle = NULL;
 	m_exitcode = 0;
 	m_isDone = false;
 }
 
-bool WorkerProcess::startProcess(UnicodeString command)
+bool WorkerProcess::startProcess(UnicodeString command, bool redirectStdInput)
 {
 	m_stdOutput.clear();
 	m_isDone = false;
@@ -87,11 +88,26 @@ bool WorkerProcess::startProcess(UnicodeString command)
 		return false;
 	SetHandleInformation(m_readHandle, HANDLE_FLAG_INHERIT, 0);
 
+	// Create pipe for writing console input
+	HANDLE inputReadHandle = NULL;
+	if (redirectStdInput)
+	{
+		if (!CreatePipe(&inputReadHandle, &m_writeHandle, &saAttr, 0))
+		{
+			CloseHandle(writeHandle);
+			CloseHandle(m_readHandle);
+			m_readHandle = NULL;
+			return false;
+		}
+		SetHandleInformation(m_writeHandle, HANDLE_FLAG_INHERIT, 0);
+	}
+
 	STARTUPINFOW si = { sizeof(STARTUPINFOW) };
 	si.dwFlags = STARTF_FORCEOFFFEEDBACK; // Prevent cursor wait animation
 	si.dwFlags |= STARTF_USESTDHANDLES;
 	si.hStdError = writeHandle;
 	si.hStdOutput = writeHandle;
+	si.hStdInput = inputReadHandle;
 
 	PROCESS_INFORMATION pi = { 0 };
 
@@ -102,11 +118,16 @@ bool WorkerProcess::startProcess(UnicodeString command)
 		CloseHandle(writeHandle);
 		CloseHandle(m_readHandle);
 		m_readHandle = NULL;
+		if (inputReadHandle != NULL)
+			CloseHandle(inputReadHandle);
+		closeStdInput();
 		return false;
 	}
 
 	CloseHandle(pi.hThread);
 	CloseHandle(writeHandle);
+	if (inputReadHandle != NULL)
+		CloseHandle(inputReadHandle);
 	m_processHandle = pi.hProcess;
 
 	// We want to make sure that when our process is killed, our workers automatically terminate as well.
@@ -143,6 +164,63 @@ AsciiString WorkerProcess::getStdOutput() const
 	return m_stdOutput;
 }
 
+bool WorkerProcess::writeStdInput(const AsciiString& input)
+{
+	DEBUG_ASSERTCRASH(m_writeHandle != NULL, ("Process was not started with redirected input"));
+	if (m_writeHandle == NULL)
+		return false;
+
+	const char* data = input.str();
+	DWORD bytesLeft = input.getLength();
+	while (bytesLeft > 0)
+	{
+		DWORD writtenBytes = 0;
+		if (!WriteFile(m_writeHandle, data, bytesLeft, &writtenBytes, NULL))
+			return false;
+		data += writtenBytes;
+		bytesLeft -= writtenBytes;
+	}
+	return true;
+}
+
+void WorkerProcess::closeStdInput()
+{
+	if (m_writeHandle != NULL)
+	{
+		CloseHandle(m_writeHandle);
+		m_writeHandle = NULL;
+	}
+}
+
+bool WorkerProcess::takeStdOutputUntilLine(const char* linePrefix, AsciiString& output, AsciiString& line)
+{
+	const char* begin = m_stdOutput.str();
+	const char* lineBegin = begin;
+	while (strncmp(lineBegin, linePrefix, strlen(linePrefix)) != 0)
+	{
+		lineBegin = strchr(lineBegin, '\n');
+		if (lineBegin == NULL)
+			return false;
+		++lineBegin;
+	}
+
+	// Only take complete lines
+	const char* lineEnd = strchr(lineBegin, '\n');
+	if (lineEnd == NULL)
+		return false;
+
+	output = m_stdOutput;
+	output.truncateTo(lineBegin - begin);
+
+	line = lineBegin;
+	line.truncateTo(lineEnd - lineBegin);
+	line.trimEnd();
+
+	AsciiString remainder = lineEnd + 1;
+	m_stdOutput = remainder;
+	return true;
+}
+
 bool WorkerProcess::fetchStdOutput()
 {
 	while (true)
@@ -195,6 +273,8 @@ void WorkerProcess::update()
 	CloseHandle(m_readHandle);
 	m_readHandle = NULL;
 
+	closeStdInput();
+
 	CloseHandle(m_jobHandle);
 	m_jobHandle = NULL;
 
@@ -219,6 +299,8 @@ void WorkerProcess::kill()
 		m_readHandle = NULL;
 	}
 
+	closeStdInput();
+
 	if (m_jobHandle != NULL)
 	{
 		CloseHandle(m_jobHandle);
@@ -62,12 +62,17 @@ void CRC::computeCRC( const void *buf, Int len )
 
 	//crc = 0;
 
+	const UnsignedInt fastCRC = addBytesToCRC(crc, (const UnsignedByte *)buf, len);
+
+	// the byte by byte version is kept as the reference for the fast one.
 	UnsignedByte *uintPtr = (UnsignedByte *)buf;
 
 	for (int i=0 ; i<len ; i++) {
 		addCRC (*(uintPtr++));
 	}
 	//crc = htonl(crc);
+
+	DEBUG_ASSERTCRASH(crc == fastCRC, ("addBytesToCRC gives %8.8X instead of %8.8X", fastCRC, crc));
 }
 
 //-------------------------------------------------------------------------------------------------
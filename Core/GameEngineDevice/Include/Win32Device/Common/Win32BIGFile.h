@@ -43,6 +43,7 @@ class Win32BIGFile : public ArchiveFile
 
 		virtual Bool					getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const;	///< fill in the fileInfo struct with info about the requested file.
 		virtual File*					openFile( const Char *filename, Int access = 0 );///< Open the specified file within the BIG file
+		virtual File*					openFile( const ArchivedFileInfo *fileInfo, const Char *filename, Int access = 0 );
 		virtual void					closeAllFiles( void );									///< Close all file opened in this BIG file
 		virtual AsciiString		getName( void );												///< Returns the name of the BIG file
 		virtual AsciiString		getPath( void );												///< Returns full path and name of BIG file
@@ -51,8 +52,16 @@ class Win32BIGFile : public ArchiveFile
 
 	protected:
 
+		Bool					mapArchive( void );	///< Map the whole BIG file into memory once, return false if it can't be mapped
+		void					unmapArchive( void );
+
 		AsciiString		m_name;		///< BIG file name
 		AsciiString		m_path;		///< BIG file path
+
+		void					*m_mappingHandle;	///< File mapping of the BIG file, NULL if not mapped
+		const Char		*m_mappedData;		///< View of the whole BIG file, NULL if not mapped
+		Int						m_mappedSize;
+		Bool					m_triedMapping;		///< The BIG file is mapped on the first read only open
 };
 
 #endif // __WIN32BIGFILE_H
@@ -58,8 +58,15 @@ StdBIGFile::~StdBIGFile()
 
 File* StdBIGFile::openFile( const Char *filename, Int access )
 {
-	const ArchivedFileInfo *fileInfo = getArchivedFileInfo(AsciiString(filename));
+	return openFile(getArchivedFileInfo(AsciiString(filename)), filename, access);
+}
+
+//============================================================================
+// StdBIGFile::openFile
+//============================================================================
 
+File* StdBIGFile::openFile( const ArchivedFileInfo *fileInfo, const Char *filename, Int access )
+{
 	if (fileInfo == NULL) {
 		return NULL;
 	}
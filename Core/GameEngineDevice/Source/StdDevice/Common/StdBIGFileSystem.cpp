@@ -56,6 +56,8 @@ void StdBIGFileSystem::init() {
 		return;
 	}
 
+	readArchiveCache();
+
 	loadBigFilesFromDirectory("", "*.big");
 
 #if RTS_ZEROHOUR
@@ -76,6 +78,8 @@ void StdBIGFileSystem::update() {
 }
 
 void StdBIGFileSystem::postProcessLoad() {
+	// all archive files that are loaded at startup are loaded by now.
+	writeArchiveCache();
 }
 
 ArchiveFile * StdBIGFileSystem::openArchiveFile(const Char *filename) {
@@ -95,6 +99,16 @@ ArchiveFile * StdBIGFileSystem::openArchiveFile(const Char *filename) {
 		return NULL;
 	}
 
+	// TheSuperHackers @performance The directory of an unchanged archive file comes from the archive cache.
+	if (m_archiveCache != NULL) {
+		ArchiveFile *cachedArchiveFile = NEW StdBIGFile;
+		if (fillArchiveFileFromCache(filename, cachedArchiveFile)) {
+			cachedArchiveFile->attachFile(fp);
+			return cachedArchiveFile;
+		}
+		delete cachedArchiveFile;
+	}
+
 	AsciiString asciibuf;
 	char buffer[_MAX_PATH];
 	fp->read(buffer, 4); // read the "BIG" at the beginning of the file.
@@ -197,6 +211,7 @@ void StdBIGFileSystem::closeArchiveFile(const Char *filename) {
 
 	// may need to do some other processing here first.
 
+	m_fileIndex.removeArchiveFile(it->second);
 	delete (it->second);
 	m_archiveFileMap.erase(it);
 }
@@ -212,10 +227,15 @@ Bool StdBIGFileSystem::loadBigFilesFromDirectory(AsciiString dir, AsciiString fi
 	FilenameList filenameList;
 	TheLocalFileSystem->getFileListInDirectory(dir, AsciiString(""), fileMask, filenameList, TRUE);
 
+	// TheSuperHackers @performance The archive files are opened in parallel, and then merged into
+	// the directory tree in the same order as before, so the same archive file wins every file.
+	std::vector<ArchiveFile *> archiveFiles;
+	openArchiveFiles(filenameList, archiveFiles);
+
 	Bool actuallyAdded = FALSE;
 	FilenameListIter it = filenameList.begin();
-	while (it != filenameList.end()) {
-		ArchiveFile *archiveFile = openArchiveFile((*it).str());
+	for (size_t i = 0; it != filenameList.end(); ++i) {
+		ArchiveFile *archiveFile = archiveFiles[i];
 
 		if (archiveFile != NULL) {
 			DEBUG_LOG(("StdBIGFileSystem::loadBigFilesFromDirectory - loading %s into the directory tree.", (*it).str()));
@@ -26,6 +26,7 @@
 // Bryan Cleveland, August 2002
 /////////////////////////////////////////////////////
 
+#include <windows.h>
 #include "Common/LocalFile.h"
 #include "Common/LocalFileSystem.h"
 #include "Common/RAMFile.h"
@@ -34,11 +35,21 @@
 #include "Common/PerfTimer.h"
 #include "Win32Device/Common/Win32BIGFile.h"
 
+// TheSuperHackers @performance Read only files are read in place from a mapping of their BIG file
+// instead of being copied into a new buffer on every open. A 32 bit process can't map all BIG files
+// at once, so the mapped size is capped there and BIG files beyond the cap are copied from as before.
+static const Int64 MaxTotalMappedBytes = sizeof(void *) > 4 ? (Int64)1 << 62 : (Int64)512 * 1024 * 1024;
+static Int64 TheTotalMappedBytes = 0;
+
 //============================================================================
 // Win32BIGFile::Win32BIGFile
 //============================================================================
 
-Win32BIGFile::Win32BIGFile()
+Win32BIGFile::Win32BIGFile() :
+	m_mappingHandle(NULL),
+	m_mappedData(NULL),
+	m_mappedSize(0),
+	m_triedMapping(FALSE)
 {
 
 }
@@ -49,7 +60,74 @@ Win32BIGFile::Win32BIGFile()
 
 Win32BIGFile::~Win32BIGFile()
 {
+	unmapArchive();
+}
+
+//============================================================================
+// Win32BIGFile::mapArchive
+//============================================================================
+
+Bool Win32BIGFile::mapArchive( void )
+{
+	if (m_triedMapping) {
+		return m_mappedData != NULL;
+	}
+	m_triedMapping = TRUE;
+
+	if (m_file == NULL) {
+		return FALSE;
+	}
 
+	const Int archiveSize = m_file->size();
+	if (archiveSize <= 0 || TheTotalMappedBytes + archiveSize > MaxTotalMappedBytes) {
+		return FALSE;
+	}
+
+	HANDLE fileHandle = CreateFileA(m_file->getName(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		return FALSE;
+	}
+
+	// The mapping keeps the file open by itself.
+	HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fileHandle);
+	if (mappingHandle == NULL) {
+		return FALSE;
+	}
+
+	const void *view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL) {
+		CloseHandle(mappingHandle);
+		return FALSE;
+	}
+
+	m_mappingHandle = mappingHandle;
+	m_mappedData = (const Char *)view;
+	m_mappedSize = archiveSize;
+	TheTotalMappedBytes += archiveSize;
+
+	DEBUG_LOG(("Win32BIGFile::mapArchive - mapped %s, %d bytes", m_file->getName(), archiveSize));
+
+	return TRUE;
+}
+
+//============================================================================
+// Win32BIGFile::unmapArchive
+//============================================================================
+
+void Win32BIGFile::unmapArchive( void )
+{
+	if (m_mappedData != NULL) {
+		UnmapViewOfFile(m_mappedData);
+		m_mappedData = NULL;
+		TheTotalMappedBytes -= m_mappedSize;
+		m_mappedSize = 0;
+	}
+
+	if (m_mappingHandle != NULL) {
+		CloseHandle((HANDLE)m_mappingHandle);
+		m_mappingHandle = NULL;
+	}
 }
 
 //============================================================================
@@ -58,12 +136,31 @@ Win32BIGFile::~Win32BIGFile()
 
 File* Win32BIGFile::openFile( const Char *filename, Int access )
 {
-	const ArchivedFileInfo *fileInfo = getArchivedFileInfo(AsciiString(filename));
+	return openFile(getArchivedFileInfo(AsciiString(filename)), filename, access);
+}
+
+//============================================================================
+// Win32BIGFile::openFile
+//============================================================================
 
+File* Win32BIGFile::openFile( const ArchivedFileInfo *fileInfo, const Char *filename, Int access )
+{
 	if (fileInfo == NULL) {
 		return NULL;
 	}
 
+	// Read only files point straight into the mapped BIG file.
+	if ((access & (File::WRITE | File::STREAMING)) == 0
+		&& fileInfo->m_offset >= 0 && fileInfo->m_size >= 0
+		&& mapArchive() && fileInfo->m_offset <= m_mappedSize - fileInfo->m_size) {
+		RAMFile *mappedFile = newInstance( RAMFile );
+		mappedFile->deleteOnClose();
+		if (mappedFile->openFromMemory(m_mappedData + fileInfo->m_offset, fileInfo->m_filename, fileInfo->m_size)) {
+			return mappedFile;
+		}
+		mappedFile->close();
+	}
+
 	RAMFile *ramFile = NULL;
 
 	if (BitIsSet(access, File::STREAMING))
@@ -57,6 +57,8 @@ void Win32BIGFileSystem::init() {
 		return;
 	}
 
+	readArchiveCache();
+
 	loadBigFilesFromDirectory("", "*.big");
 
 #if RTS_ZEROHOUR
@@ -77,6 +79,8 @@ void Win32BIGFileSystem::update() {
 }
 
 void Win32BIGFileSystem::postProcessLoad() {
+	// all archive files that are loaded at startup are loaded by now.
+	writeArchiveCache();
 }
 
 ArchiveFile * Win32BIGFileSystem::openArchiveFile(const Char *filename) {
@@ -94,6 +98,16 @@ ArchiveFile * Win32BIGFileSystem::openArchiveFile(const Char *filename) {
 		return NULL;
 	}
 
+	// TheSuperHackers @performance The directory of an unchanged archive file comes from the archive cache.
+	if (m_archiveCache != NULL) {
+		ArchiveFile *cachedArchiveFile = NEW Win32BIGFile;
+		if (fillArchiveFileFromCache(filename, cachedArchiveFile)) {
+			cachedArchiveFile->attachFile(fp);
+			return cachedArchiveFile;
+		}
+		delete cachedArchiveFile;
+	}
+
 	AsciiString asciibuf;
 	char buffer[_MAX_PATH];
 	fp->read(buffer, 4); // read the "BIG" at the beginning of the file.
@@ -198,6 +212,7 @@ void Win32BIGFileSystem::closeArchiveFile(const Char *filename) {
 
 	// may need to do some other processing here first.
 
+	m_fileIndex.removeArchiveFile(it->second);
 	delete (it->second);
 	m_archiveFileMap.erase(it);
 }
@@ -213,10 +228,15 @@ Bool Win32BIGFileSystem::loadBigFilesFromDirectory(AsciiString dir, AsciiString
 	FilenameList filenameList;
 	TheLocalFileSystem->getFileListInDirectory(dir, AsciiString(""), fileMask, filenameList, TRUE);
 
+	// TheSuperHackers @performance The archive files are opened in parallel, and then merged into
+	// the directory tree in the same order as before, so the same archive file wins every file.
+	std::vector<ArchiveFile *> archiveFiles;
+	openArchiveFiles(filenameList, archiveFiles);
+
 	Bool actuallyAdded = FALSE;
 	FilenameListIter it = filenameList.begin();
-	while (it != filenameList.end()) {
-		ArchiveFile *archiveFile = openArchiveFile((*it).str());
+	for (size_t i = 0; it != filenameList.end(); ++i) {
+		ArchiveFile *archiveFile = archiveFiles[i];
 
 		if (archiveFile != NULL) {
 			DEBUG_LOG(("Win32BIGFileSystem::loadBigFilesFromDirectory - loading %s into the directory tree.", (*it).str()));
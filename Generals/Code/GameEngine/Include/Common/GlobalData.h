@@ -346,6 +346,8 @@ public:
 
 	std::vector<AsciiString> m_simulateReplays; ///< If not empty, simulate this list of replays and exit.
 	Int m_simulateReplayJobs; ///< Maximum number of processes to use for simulation, or SIMULATE_REPLAYS_SEQUENTIAL for sequential simulation
+	Bool m_simulateReplaysInPersistentJobs; ///< Reuse each worker process for many replays instead of starting one process per replay
+	Bool m_simulateReplayWorker; ///< If true, this is a persistent worker process that receives replays to simulate on its standard input
 
 	Int m_maxParticleCount;						///< maximum number of particles that can exist
 	Int m_maxFieldParticleCount;			///< maximum number of field-type particles that can exist (roughly)
@@ -532,6 +534,7 @@ public:
 
 	AsciiString m_modDir;
 	AsciiString m_modBIG;
+	AsciiString m_archiveCacheFile;		///< If not empty, take the directories of unchanged BIG files from this file and update it
 
 	// the trailing '\' is included!
 	AsciiString getPath_UserData() const;
@@ -224,6 +224,7 @@ protected:
 	PathfindCell *m_cell;															///< Cell this info belongs to currently.
 
 	UnsignedShort m_totalCost, m_costSoFar;	///< cost estimates for A* search
+	UnsignedShort m_openCost;			///< m_totalCost at the time this cell was put on the open list
 
 	/// have to include cell's coordinates, since cells are often accessed via pointer only
 	ICoord2D m_pos;
@@ -317,6 +318,9 @@ public:
 	/// remove all cells from closed list.
 	static Int releaseOpenList( PathfindCell *list );
 
+	/// forget all cells of the open list index, for when the open list is discarded without releasing it.
+	static void resetOpenListIndex( void );
+
 	inline PathfindCell *getNextOpen(void) {return m_info->m_nextOpen?m_info->m_nextOpen->m_cell:NULL;}
 
 	inline UnsignedShort getXIndex(void) const {return m_info->m_pos.x;}
@@ -157,6 +157,23 @@ enum DistanceCalculationType CPP_11(: Int)
 	FROM_BOUNDINGSPHERE_3D	= 3		///< measure from Object bounding sphere in 3d.
 };
 
+//=====================================
+/**
+	Callers that opt into sharing the candidates of their range queries with the other
+	queries around the same cell in the same logic frame. Each one has its own hit counters.
+*/
+//=====================================
+enum RangeQueryCacheUser CPP_11(: Int)
+{
+	RANGE_QUERY_NOT_CACHED = -1,
+
+	RANGE_QUERY_FIND_CLOSEST_ENEMY,
+	RANGE_QUERY_STEALTH_DETECTOR,
+	RANGE_QUERY_AUTO_FIND_HEALING,
+
+	RANGE_QUERY_USER_COUNT
+};
+
 //=====================================
 /**
 	a Plain Old Data structure that is used to get optional results from collidesWith().
@@ -546,6 +563,7 @@ public:
 	void friend_removeAllTouchedCells() { removeAllTouchedCells(); }	///< this is only for use by PartitionManager
 	void friend_updateCellsTouched()	{ updateCellsTouched(); } ///< this is only for use by PartitionManager
 	Int friend_getCoiInUseCount() { return m_coiInUseCount; } ///< this is only for use by PartitionManager
+	PartitionCell *friend_getFirstCellTouched() { return m_coiInUseCount > 0 ? m_coiArray[0].getCell() : NULL; } ///< this is only for use by PartitionManager
 	Bool friend_collidesWith(const PartitionData *that, CollideLocAndNormal *cinfo) const { return collidesWith(that, cinfo); }	///< this is only for use by PartitionContactList
 
 	// these are only for use by getClosestObjects.
@@ -1202,6 +1220,33 @@ private:
 #ifdef FASTER_GCO
 	typedef std::vector<ICoord2D>		OffsetVec;
 	typedef std::vector<OffsetVec>	RadiusVec;
+
+	/// an object found by a range query, with the radius (in cells) of the cell it was found in.
+	struct RangeQueryCandidate
+	{
+		Object *obj;
+		Int radius;
+	};
+	typedef std::vector<RangeQueryCandidate> RangeQueryCandidateVec;
+
+	/**
+		All objects out to maxRadius around a cell, in the order that getClosestObjects visits them.
+		The queries still do their own distance checks and filters on these, so the results don't change.
+	*/
+	struct RangeQueryCacheEntry
+	{
+		Int cellX;
+		Int cellY;
+		Int maxRadius;
+		UnsignedInt stamp;
+		RangeQueryCandidateVec candidates;
+	};
+
+	enum
+	{
+		RANGE_QUERY_CACHE_SIZE = 256,		///< must be a power of two
+		RANGE_QUERY_RADIUS_BUCKET = 4		///< cached radii are rounded up to this many cells, so that similar queries can share them
+	};
 #endif
 
 	PartitionData		*m_moduleList;		///< master partition module list
@@ -1221,6 +1266,11 @@ private:
 #ifdef FASTER_GCO
 	Int							m_maxGcoRadius;
 	RadiusVec				m_radiusVec;
+
+	RangeQueryCacheEntry	m_rangeQueryCache[RANGE_QUERY_CACHE_SIZE];
+	UnsignedInt			m_rangeQueryCacheStamp;		///< changes whenever the cached candidates may be out of date
+	UnsignedInt			m_rangeQueryCacheHits[RANGE_QUERY_USER_COUNT];
+	UnsignedInt			m_rangeQueryCacheMisses[RANGE_QUERY_USER_COUNT];
 #endif
 
 protected:
@@ -1237,9 +1287,15 @@ protected:
 		PartitionFilter **filters,
 		SimpleObjectIterator *iter,	// if nonnull, append ALL satisfactory objects to the iterator (not just the single closest)
 		Real *closestDistArg,
-		Coord3D *closestVecArg
+		Coord3D *closestVecArg,
+		RangeQueryCacheUser cacheUser = RANGE_QUERY_NOT_CACHED
 	);
 
+#ifdef FASTER_GCO
+	/// return the cached candidates out to maxRadius around the given cell, gathering them if needed.
+	const RangeQueryCandidateVec& getRangeQueryCandidates(Int cellX, Int cellY, Int maxRadius, RangeQueryCacheUser cacheUser);
+#endif
+
 	void shutdown( void );
 
 	/// used to validate the positions for findPositionAround family of methods
@@ -1339,7 +1395,8 @@ public:
 		DistanceCalculationType dc,
 		PartitionFilter **filters = NULL,
 		Real *closestDist = NULL,
-		Coord3D *closestDistVec = NULL
+		Coord3D *closestDistVec = NULL,
+		RangeQueryCacheUser cacheUser = RANGE_QUERY_NOT_CACHED
 	);
 	Object *getClosestObject(
 		const Coord3D *pos,
@@ -1347,7 +1404,8 @@ public:
 		DistanceCalculationType dc,
 		PartitionFilter **filters = NULL,
 		Real *closestDist = NULL,
-		Coord3D *closestDistVec = NULL
+		Coord3D *closestDistVec = NULL,
+		RangeQueryCacheUser cacheUser = RANGE_QUERY_NOT_CACHED
 	);
 
 	Real getRelativeAngle2D( const Object *obj, const Object *otherObj );
@@ -1380,7 +1438,8 @@ public:
 		Real maxDist,
 		DistanceCalculationType dc,
 		PartitionFilter **filters = NULL,
-		IterOrderType order = ITER_FASTEST
+		IterOrderType order = ITER_FASTEST,
+		RangeQueryCacheUser cacheUser = RANGE_QUERY_NOT_CACHED
 	);
 
 	SimpleObjectIterator *iterateObjectsInRange(
@@ -1388,11 +1447,23 @@ public:
 		Real maxDist,
 		DistanceCalculationType dc,
 		PartitionFilter **filters = NULL,
-		IterOrderType order = ITER_FASTEST
+		IterOrderType order = ITER_FASTEST,
+		RangeQueryCacheUser cacheUser = RANGE_QUERY_NOT_CACHED
 	);
 
 	SimpleObjectIterator *iterateAllObjects(PartitionFilter **filters = NULL);
 
+	/// forget the candidates cached by the range queries, because the objects in the cells have changed.
+	inline void invalidateRangeQueryCache( void )
+	{
+#ifdef FASTER_GCO
+		++m_rangeQueryCacheStamp;
+#endif
+	}
+
+	/// return how many range queries of the given user were served from the cache, since the last reset.
+	void getRangeQueryCacheStats(RangeQueryCacheUser cacheUser, UnsignedInt& hits, UnsignedInt& misses) const;
+
 	/**
 		return the Objects that would (or would not) collide with the given
 		geometry.
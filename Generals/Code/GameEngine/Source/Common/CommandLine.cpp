@@ -443,6 +443,28 @@ Int parseReplay(char *args[], int num)
 	return 1;
 }
 
+Int parseReplayWorker(char *args[], int num)
+{
+	TheWritableGlobalData->m_simulateReplayWorker = TRUE;
+
+	TheWritableGlobalData->m_playIntro = FALSE;
+	TheWritableGlobalData->m_afterIntro = TRUE;
+	TheWritableGlobalData->m_playSizzle = FALSE;
+	TheWritableGlobalData->m_shellMapOn = FALSE;
+
+	// Make replay playback possible while other clients (possible retail) are running
+	rts::ClientInstance::setMultiInstance(TRUE);
+	rts::ClientInstance::skipPrimaryInstance();
+
+	return 1;
+}
+
+Int parsePersistentJobs(char *args[], int num)
+{
+	TheWritableGlobalData->m_simulateReplaysInPersistentJobs = TRUE;
+	return 1;
+}
+
 Int parseJobs(char *args[], int num)
 {
 	if (num > 1)
@@ -458,6 +480,16 @@ Int parseJobs(char *args[], int num)
 	return 1;
 }
 
+Int parseArchiveCache(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_archiveCacheFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
 Int parseXRes(char *args[], int num)
 {
 	if (num > 1)
@@ -1163,6 +1195,16 @@ static CommandLineParam paramsForStartup[] =
 	// (If you have 4 cores, call it with -jobs 4)
 	// If you do not call this, all replays will be simulated in sequence in the same process.
 	{ "-jobs", parseJobs },
+
+	// Keep each of the -jobs processes alive and send it one replay after another, so that the game data
+	// is only loaded once per process instead of once per replay. Requires -headless.
+	{ "-persistentJobs", parsePersistentJobs },
+
+	// Used internally by -persistentJobs. Simulates the replays that are received on the standard input.
+	{ "-replayWorker", parseReplayWorker },
+
+	// Take the directories of the BIG files that did not change from the given cache file, and write it when any did
+	{ "-archiveCache", parseArchiveCache },
 };
 
 // These Params are parsed during Engine Init before INI data is loaded
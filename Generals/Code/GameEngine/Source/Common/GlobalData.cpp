@@ -958,6 +958,10 @@ GlobalData::GlobalData()
 
 	m_simulateReplays.clear();
 	m_simulateReplayJobs = SIMULATE_REPLAYS_SEQUENTIAL;
+	m_simulateReplaysInPersistentJobs = FALSE;
+	m_simulateReplayWorker = FALSE;
+
+	m_archiveCacheFile.clear();
 
 	for (i = LEVEL_FIRST; i <= LEVEL_LAST; ++i)
 		m_healthBonus[i] = 1.0f;
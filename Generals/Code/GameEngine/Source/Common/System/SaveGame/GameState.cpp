@@ -589,6 +589,9 @@ SaveCode GameState::saveGame( AsciiString filename, UnicodeString desc,
 		// save file
 		xferSaveData( &xferSave, which );
 
+		// write the rest of the file, so that a write error is reported here
+		xferSave.flush();
+
 	}  // end try
 	catch( ... )
 	{
@@ -1080,6 +1080,125 @@ Real Path::computeFlightDistToGoal( const Coord3D *pos, Coord3D& goalPos )
 
 enum { PATHFIND_CELLS_PER_FRAME=5000}; // Number of cells we will search pathfinding per frame.
 enum {CELL_INFOS_TO_ALLOCATE = 30000};
+
+//-----------------------------------------------------------------------------------
+
+static inline Int highestBitIndex(UnsignedInt bits)
+{
+	DEBUG_ASSERTCRASH(bits != 0, ("Need at least one bit set."));
+	Int index = 0;
+	if (bits & 0xFFFF0000) { bits >>= 16; index += 16; }
+	if (bits & 0xFF00) { bits >>= 8; index += 8; }
+	if (bits & 0xF0) { bits >>= 4; index += 4; }
+	if (bits & 0xC) { bits >>= 2; index += 2; }
+	if (bits & 0x2) { index += 1; }
+	return index;
+}
+
+/**
+ * Radix index into the sorted A* "open" list, so a cell can be inserted without walking the list.
+ * For every total cost present on the open list, it remembers the last cell with that cost, and a
+ * two level bitmap finds the closest cost that is less than or equal to a given one.
+ * Inserting a cell after the last cell with a cost less or equal than its own is exactly what the
+ * insertion sort of the open list did, so cells still come off the open list in the same order.
+ */
+class PathfindOpenListIndex
+{
+public:
+	PathfindOpenListIndex() { reset(); }
+
+	void reset(void)
+	{
+		memset(m_lastCell, 0, sizeof(m_lastCell));
+		memset(m_costBits, 0, sizeof(m_costBits));
+		memset(m_wordBits, 0, sizeof(m_wordBits));
+		m_count = 0;
+	}
+
+	/// Forget all cells. Only the costs in use are touched, as a cost has a last cell exactly when its bit is set.
+	void clear(void)
+	{
+		Int summary;
+		for (summary = 0; summary < NUM_SUMMARY_WORDS; ++summary)
+		{
+			UnsignedInt words = m_wordBits[summary];
+			while (words != 0)
+			{
+				const Int word = (summary << 5) + highestBitIndex(words);
+				words &= ~(1u << (word & 31));
+				UnsignedInt bits = m_costBits[word];
+				while (bits != 0)
+				{
+					const Int cost = (word << 5) + highestBitIndex(bits);
+					bits &= ~(1u << (cost & 31));
+					m_lastCell[cost] = NULL;
+				}
+				m_costBits[word] = 0;
+			}
+			m_wordBits[summary] = 0;
+		}
+		m_count = 0;
+	}
+
+	Bool isEmpty(void) const { return m_count == 0; }
+
+	/// Return the last cell on the open list with a cost less or equal than cost, or NULL if there is none.
+	PathfindCell *findLastCell(UnsignedShort cost) const
+	{
+		Int word = cost >> 5;
+		UnsignedInt bits = m_costBits[word] & (0xFFFFFFFF >> (31 - (cost & 31)));
+		if (bits == 0)
+		{
+			Int summary = word >> 5;
+			UnsignedInt words = m_wordBits[summary] & ((1u << (word & 31)) - 1);
+			while (words == 0)
+			{
+				if (--summary < 0)
+					return NULL;
+				words = m_wordBits[summary];
+			}
+			word = (summary << 5) + highestBitIndex(words);
+			bits = m_costBits[word];
+		}
+		return m_lastCell[(word << 5) + highestBitIndex(bits)];
+	}
+
+	/// The cell was linked into the open list right after findLastCell(cost).
+	void addCell(PathfindCell *cell, UnsignedShort cost)
+	{
+		m_lastCell[cost] = cell;
+		m_costBits[cost >> 5] |= 1u << (cost & 31);
+		m_wordBits[cost >> 10] |= 1u << ((cost >> 5) & 31);
+		++m_count;
+	}
+
+	/// The cell is about to be unlinked from the open list. prevCell is the cell in front of it, if it has the same cost.
+	void removeCell(PathfindCell *cell, UnsignedShort cost, PathfindCell *prevCellWithSameCost)
+	{
+		DEBUG_ASSERTCRASH(m_count > 0, ("Open list index is out of sync."));
+		--m_count;
+		if (m_lastCell[cost] != cell)
+			return;
+
+		m_lastCell[cost] = prevCellWithSameCost;
+		if (prevCellWithSameCost != NULL)
+			return;
+
+		m_costBits[cost >> 5] &= ~(1u << (cost & 31));
+		if (m_costBits[cost >> 5] == 0)
+			m_wordBits[cost >> 10] &= ~(1u << ((cost >> 5) & 31));
+	}
+
+private:
+	enum { NUM_COSTS = 0x10000, NUM_COST_WORDS = NUM_COSTS / 32, NUM_SUMMARY_WORDS = NUM_COST_WORDS / 32 };
+
+	PathfindCell *m_lastCell[NUM_COSTS];				///< Last cell on the open list for each cost
+	UnsignedInt m_costBits[NUM_COST_WORDS];			///< Bit per cost that has cells on the open list
+	UnsignedInt m_wordBits[NUM_SUMMARY_WORDS];	///< Bit per m_costBits word that is not zero
+	Int m_count;																///< Number of cells on the open list
+};
+
+static PathfindOpenListIndex s_openListIndex;
 PathfindCellInfo *PathfindCellInfo::s_infoArray = NULL;
 PathfindCellInfo *PathfindCellInfo::s_firstFree = NULL;
 /**
@@ -1222,6 +1341,11 @@ Bool PathfindCell::startPathfind( PathfindCell *goalCell  )
 	}
 	m_info->m_open = TRUE;
 	m_info->m_closed = FALSE;
+
+	// This cell is the whole new open list. Searches that returned early may have left cells in the index.
+	s_openListIndex.clear();
+	m_info->m_openCost = m_info->m_totalCost;
+	s_openListIndex.addCell(this, m_info->m_openCost);
 	return true;
 }
 /**
@@ -1488,46 +1612,37 @@ PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
 {
 	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
 	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
-	if (list == NULL)
+	DEBUG_ASSERTCRASH((list == NULL) == s_openListIndex.isEmpty(), ("Open list index is out of sync."));
+
+	// Insert after the last cell with a cost less or equal than ours, same as an insertion sort
+	// walking the list from the front would.
+	PathfindCell *lastCell = list ? s_openListIndex.findLastCell(m_info->m_totalCost) : NULL;
+	if (lastCell == NULL)
 	{
-		list = this;
+		// insert at front of list
 		m_info->m_prevOpen = NULL;
-		m_info->m_nextOpen = NULL;
+		m_info->m_nextOpen = list ? list->m_info : NULL;
+		if (list)
+			list->m_info->m_prevOpen = this->m_info;
+		list = this;
 	}
 	else
 	{
-		// insertion sort
-		PathfindCell *c, *lastCell = NULL;
-		for( c = list; c; c = c->getNextOpen() )
-		{
-			if (c->m_info->m_totalCost > m_info->m_totalCost)
-				break;
-
-			lastCell = c;
-		}
-
-		if (c)
-		{
-			// insert just before "c"
-			if (c->m_info->m_prevOpen)
-				c->m_info->m_prevOpen->m_nextOpen = this->m_info;
-			else
-				list = this;
+		// insert just after "lastCell"
+		m_info->m_prevOpen = lastCell->m_info;
+		m_info->m_nextOpen = lastCell->m_info->m_nextOpen;
+		if (m_info->m_nextOpen)
+			m_info->m_nextOpen->m_prevOpen = this->m_info;
+		lastCell->m_info->m_nextOpen = this->m_info;
+	}
 
-			m_info->m_prevOpen = c->m_info->m_prevOpen;
-			c->m_info->m_prevOpen = this->m_info;
+#ifdef RTS_DEBUG
+	DEBUG_ASSERTCRASH(m_info->m_prevOpen == NULL || m_info->m_prevOpen->m_openCost <= m_info->m_totalCost, ("Open list is not sorted."));
+	DEBUG_ASSERTCRASH(m_info->m_nextOpen == NULL || m_info->m_nextOpen->m_openCost > m_info->m_totalCost, ("Open list is not sorted."));
+#endif
 
-			m_info->m_nextOpen = c->m_info;
-
-		}
-		else
-		{
-			// append after "lastCell" - end of list
-			lastCell->m_info->m_nextOpen = this->m_info;
-			m_info->m_prevOpen = lastCell->m_info;
-			m_info->m_nextOpen = NULL;
-		}
-	}
+	m_info->m_openCost = m_info->m_totalCost;
+	s_openListIndex.addCell(this, m_info->m_openCost);
 
 	// mark newCell as being on open list
 	m_info->m_open = true;
@@ -1541,6 +1656,12 @@ PathfindCell *PathfindCell::removeFromOpenList( PathfindCell *list )
 {
 	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
 	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
+
+	// Note that m_totalCost may already have changed, so use the cost we were inserted with.
+	PathfindCellInfo *prevInfo = m_info->m_prevOpen;
+	PathfindCell *prevCellWithSameCost = (prevInfo && prevInfo->m_openCost == m_info->m_openCost) ? prevInfo->m_cell : NULL;
+	s_openListIndex.removeCell(this, m_info->m_openCost, prevCellWithSameCost);
+
 	if (m_info->m_nextOpen)
 		m_info->m_nextOpen->m_prevOpen = m_info->m_prevOpen;
 
@@ -1572,14 +1693,23 @@ Int PathfindCell::releaseOpenList( PathfindCell *list )
 			list = NULL;
 		}
 		DEBUG_ASSERTCRASH(cur == curInfo->m_cell, ("Bad backpointer in PathfindCellInfo"));
+		// The list is released front to back, so no cell in front of this one is left.
+		s_openListIndex.removeCell(cur, curInfo->m_openCost, NULL);
 		curInfo->m_nextOpen = NULL;
 		curInfo->m_prevOpen = NULL;
 		curInfo->m_open = FALSE;
 		cur->releaseInfo();
 	}
+	DEBUG_ASSERTCRASH(s_openListIndex.isEmpty(), ("Open list index is out of sync."));
 	return count;
 }
 
+/// forget all cells of the open list index
+void PathfindCell::resetOpenListIndex( void )
+{
+	s_openListIndex.reset();
+}
+
 /// remove all cells from "closed" list
 Int PathfindCell::releaseClosedList( PathfindCell *list )
 {
@@ -3414,6 +3544,7 @@ void Pathfinder::reset( void )
 	m_extent.lo.x=m_extent.lo.y=m_extent.hi.x=m_extent.hi.y=0;
 	m_logicalExtent.lo.x=m_logicalExtent.lo.y=m_logicalExtent.hi.x=m_logicalExtent.hi.y=0;
 	m_openList = NULL;
+	PathfindCell::resetOpenListIndex();
 	m_closedList = NULL;
 
 	m_ignoreObstacleID = INVALID_ID;
@@ -195,7 +195,7 @@ UpdateSleepTime StealthDetectorUpdate::update( void )
 	Bool foundSomeone = FALSE;
 
 	SimpleObjectIterator *iter = ThePartitionManager->iterateObjectsInRange(
-								self, visionRange, FROM_CENTER_2D, filters);
+								self, visionRange, FROM_CENTER_2D, filters, ITER_FASTEST, RANGE_QUERY_STEALTH_DETECTOR);
 	MemoryPoolObjectHolder hold(iter);
 	for (Object *them = iter->first(); them; them = iter->next())
 	{
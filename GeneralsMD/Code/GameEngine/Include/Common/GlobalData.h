@@ -354,6 +354,17 @@ public:
 
 	std::vector<AsciiString> m_simulateReplays; ///< If not empty, simulate this list of replays and exit.
 	Int m_simulateReplayJobs; ///< Maximum number of processes to use for simulation, or SIMULATE_REPLAYS_SEQUENTIAL for sequential simulation
+	Bool m_simulateReplaysInPersistentJobs; ///< Reuse each worker process for many replays instead of starting one process per replay
+	Bool m_simulateReplayWorker; ///< If true, this is a persistent worker process that receives replays to simulate on its standard input
+
+	AsciiString m_pathfindCaptureFile; ///< If not empty, write every queued path request to this file
+	AsciiString m_pathfindBenchmarkFile; ///< If not empty, repeat the path requests of this file at their frame and measure them
+	AsciiString m_logicProfileFile; ///< If not empty, write the time of every logic frame per subsystem and update module to this file
+	AsciiString m_scriptProfileFile; ///< If not empty, write the time of every script and script condition and action type to this file
+	Bool m_benchmarkMemoryPools; ///< If true, measure the allocations of all memory pools and exit
+	AsciiString m_memoryPoolProfileFile; ///< If not empty, write the peak block count of every memory pool to this file on exit
+	Bool m_incrementalObjectCRC; ///< If true, the game CRC only recalculates the CRC of objects that changed. Not retail compatible
+	UnsignedInt m_xferBenchmarkFrame; ///< If not 0, measure saving and CRCing the game state when the logic reaches this frame
 
 	Int m_maxParticleCount;						///< maximum number of particles that can exist
 	Int m_maxFieldParticleCount;			///< maximum number of field-type particles that can exist (roughly)
@@ -544,6 +555,7 @@ public:
 	Bool				m_breakTheMovie;								///< The user has hit escape!
 	AsciiString m_modDir;
 	AsciiString m_modBIG;
+	AsciiString m_archiveCacheFile;		///< If not empty, take the directories of unchanged BIG files from this file and update it
 
 	//-allAdvice feature
 	//Bool m_allAdvice;
@@ -49,6 +49,7 @@
 class Particle;
 class ParticleSystem;
 class ParticleSystemManager;
+struct ParticleUpdateContext;
 class Drawable;
 class Object;
 struct FieldParse;
@@ -170,8 +171,8 @@ public:
 
 	Particle( ParticleSystem *system, const ParticleInfo *data );
 
-	inline Bool update( void );												///< update this particle's behavior - return false if dead
-	void doWindMotion( void );									///< do wind motion (if present) from particle system
+	inline Bool update( const ParticleUpdateContext& context );	///< update this particle's behavior - return false if dead
+	void doWindMotion( const ParticleUpdateContext& context );	///< do wind motion (if present) from particle system
 
 	void applyForce( const Coord3D *force );		///< add the given acceleration
 
@@ -475,6 +476,24 @@ public:
 
 };
 
+/**
+ * The values of a particle system that are the same for all of its particles in a frame.
+ * TheSuperHackers @performance The system computes them once per update instead of each
+ * particle fetching them, and looking up the attached object or drawable for wind, again.
+ */
+struct ParticleUpdateContext
+{
+	Coord3D driftVelocity;																///< drift velocity of the system
+	Real gravity;																					///< gravity of the system, added to the velocity
+	ParticleSystemInfo::ParticleShaderType shaderType;		///< shader type of the system
+	UnsignedInt frame;																		///< current client frame
+
+	Bool useWind;																					///< TRUE if the system has wind motion
+	Coord3D windPos;																			///< world position the wind blows from
+	Real windCos;																					///< cosine of the wind angle
+	Real windSin;																					///< sine of the wind angle
+};
+
 
 /**
  * A ParticleSystemTemplate, used by the ParticleSystemManager to instantiate ParticleSystems.
@@ -553,6 +572,7 @@ public:
 
 	virtual Bool update( Int localPlayerIndex );								///< update this particle system, return false if dead
 	void updateWindMotion( void );							///< update wind motion
+	void computeParticleUpdateContext( ParticleUpdateContext *context );	///< compute the per frame values shared by all particles
 
 	void setControlParticle( Particle *p );			///< set control particle
 
@@ -42,6 +42,7 @@ class Bridge;
 class Object;
 class Weapon;
 class PathfindZoneManager;
+class PathfindBenchmark;
 
 // How close is close enough when moving.
 
@@ -225,6 +226,7 @@ protected:
 	PathfindCell *m_cell;															///< Cell this info belongs to currently.
 
 	UnsignedShort m_totalCost, m_costSoFar;	///< cost estimates for A* search
+	UnsignedShort m_openCost;			///< m_totalCost at the time this cell was put on the open list
 
 	/// have to include cell's coordinates, since cells are often accessed via pointer only
 	ICoord2D m_pos;
@@ -274,6 +276,9 @@ public:
 		UNIT_GOAL_OTHER_MOVING	= 0x05		///< A unit is moving through this cell, and another unit has this as it's goal.
 	};
 
+	enum { ZONE_BITS = 14 };
+	enum { MAX_CELL_ZONES = 1 << ZONE_BITS };	///< Zones stored in a cell must be below this.
+
 	/// reset the cell
 	void reset( );
 
@@ -289,9 +294,9 @@ public:
 
 	Bool isObstaclePresent( ObjectID objID ) const;					///< return true if the given object ID is registered as an obstacle in this cell
 
-	Bool isObstacleTransparent( ) const{return m_info?m_info->m_obstacleIsTransparent:false; }					///< return true if the obstacle in the cell is KINDOF_CAN_SEE_THROUGHT_STRUCTURE
+	Bool isObstacleTransparent( ) const{return hasInfo()?getInfo()->m_obstacleIsTransparent:false; }					///< return true if the obstacle in the cell is KINDOF_CAN_SEE_THROUGHT_STRUCTURE
 
-	Bool isObstacleFence( void ) const {return m_info?m_info->m_obstacleIsFence:false; }///< return true if the given obstacle in the cell is a fence.
+	Bool isObstacleFence( void ) const {return hasInfo()?getInfo()->m_obstacleIsFence:false; }///< return true if the given obstacle in the cell is a fence.
 
 	/// Return estimated cost from given cell to reach goal cell
 	UnsignedInt costToGoal( PathfindCell *goal );
@@ -318,26 +323,29 @@ public:
 	/// remove all cells from closed list.
 	static Int releaseOpenList( PathfindCell *list );
 
-	inline PathfindCell *getNextOpen(void) {return m_info->m_nextOpen?m_info->m_nextOpen->m_cell:NULL;}
+	/// forget all cells of the open list index, for when the open list is discarded without releasing it.
+	static void resetOpenListIndex( void );
+
+	inline PathfindCell *getNextOpen(void) {return getInfo()->m_nextOpen?getInfo()->m_nextOpen->m_cell:NULL;}
 
-	inline UnsignedShort getXIndex(void) const {return m_info->m_pos.x;}
-	inline UnsignedShort getYIndex(void) const {return m_info->m_pos.y;}
+	inline UnsignedShort getXIndex(void) const {return getInfo()->m_pos.x;}
+	inline UnsignedShort getYIndex(void) const {return getInfo()->m_pos.y;}
 
-	inline Bool isBlockedByAlly(void) const {return m_info->m_blockedByAlly;}
-	inline void setBlockedByAlly(Bool blocked)  {m_info->m_blockedByAlly = (blocked!=0);}
+	inline Bool isBlockedByAlly(void) const {return getInfo()->m_blockedByAlly;}
+	inline void setBlockedByAlly(Bool blocked)  {getInfo()->m_blockedByAlly = (blocked!=0);}
 
-	inline Bool getOpen(void) const {return m_info->m_open;}
-	inline Bool getClosed(void) const {return m_info->m_closed;}
-	inline UnsignedInt getCostSoFar(void) const {return m_info->m_costSoFar;}
-	inline UnsignedInt getTotalCost(void) const {return m_info->m_totalCost;}
+	inline Bool getOpen(void) const {return getInfo()->m_open;}
+	inline Bool getClosed(void) const {return getInfo()->m_closed;}
+	inline UnsignedInt getCostSoFar(void) const {return getInfo()->m_costSoFar;}
+	inline UnsignedInt getTotalCost(void) const {return getInfo()->m_totalCost;}
 
-	inline void setCostSoFar(UnsignedInt cost) { if( m_info ) m_info->m_costSoFar = cost;}
-	inline void setTotalCost(UnsignedInt cost) { if( m_info ) m_info->m_totalCost = cost;}
+	inline void setCostSoFar(UnsignedInt cost) { if( hasInfo() ) getInfo()->m_costSoFar = cost;}
+	inline void setTotalCost(UnsignedInt cost) { if( hasInfo() ) getInfo()->m_totalCost = cost;}
 
 	void setParentCell(PathfindCell* parent);
 	void clearParentCell(void);
 	void setParentCellHierarchical(PathfindCell* parent);
-	inline PathfindCell* getParentCell(void) const {return m_info ? m_info->m_pathParent ? m_info->m_pathParent->m_cell : NULL : NULL;}
+	inline PathfindCell* getParentCell(void) const {return hasInfo() ? getInfo()->m_pathParent ? getInfo()->m_pathParent->m_cell : NULL : NULL;}
 
 	Bool startPathfind( PathfindCell *goalCell );
 	Bool getPinched(void) const {return m_pinched;}
@@ -345,17 +353,17 @@ public:
 
 	Bool allocateInfo(const ICoord2D &pos);
 	void releaseInfo(void);
-	Bool hasInfo(void) const {return m_info!=NULL;}
+	Bool hasInfo(void) const {return m_infoIndex!=NO_CELL_INFO;}
 	zoneStorageType getZone(void) const {return m_zone;}
 	void setZone(zoneStorageType zone) {m_zone = zone;}
 	void setGoalUnit(ObjectID unit, const ICoord2D &pos );
 	void setGoalAircraft(ObjectID unit, const ICoord2D &pos );
 	void setPosUnit(ObjectID unit, const ICoord2D &pos );
-	inline ObjectID getGoalUnit(void) const {ObjectID id = m_info?m_info->m_goalUnitID:INVALID_ID; return id;}
-	inline ObjectID getGoalAircraft(void) const {ObjectID id = m_info?m_info->m_goalAircraftID:INVALID_ID; return id;}
-	inline ObjectID getPosUnit(void) const {ObjectID id = m_info?m_info->m_posUnitID:INVALID_ID; return id;}
+	inline ObjectID getGoalUnit(void) const {ObjectID id = hasInfo()?getInfo()->m_goalUnitID:INVALID_ID; return id;}
+	inline ObjectID getGoalAircraft(void) const {ObjectID id = hasInfo()?getInfo()->m_goalAircraftID:INVALID_ID; return id;}
+	inline ObjectID getPosUnit(void) const {ObjectID id = hasInfo()?getInfo()->m_posUnitID:INVALID_ID; return id;}
 
-	inline ObjectID getObstacleID(void) const {ObjectID id = m_info?m_info->m_obstacleID:INVALID_ID; return id;}
+	inline ObjectID getObstacleID(void) const {ObjectID id = hasInfo()?getInfo()->m_obstacleID:INVALID_ID; return id;}
 
 	void setLayer( PathfindLayerEnum layer ) { m_layer = layer; }	///< set the cell layer
 	PathfindLayerEnum getLayer( void ) const { return (PathfindLayerEnum)m_layer; }				///< get the cell layer
@@ -364,8 +372,13 @@ public:
 	PathfindLayerEnum getConnectLayer( void ) const { return (PathfindLayerEnum)m_connectsToLayer; }				///< get the cell layer connect id
 
 private:
-	PathfindCellInfo *m_info;
-	zoneStorageType m_zone:14;			///< Zone. Each zone is a set of adjacent terrain type.  If from & to in the same zone, you can successfully pathfind.  If not,
+	enum { NO_CELL_INFO = 0xffff };
+
+	inline PathfindCellInfo *getInfo(void) const {return hasInfo() ? PathfindCellInfo::s_infoArray + m_infoIndex : NULL;}
+	inline void setInfo(PathfindCellInfo *info) {m_infoIndex = info ? (UnsignedShort)(info - PathfindCellInfo::s_infoArray) : NO_CELL_INFO;}
+
+	UnsignedShort m_infoIndex;			///< Index of the pathfinding info in PathfindCellInfo::s_infoArray, or NO_CELL_INFO. Keeps the cell at 6 bytes.
+	zoneStorageType m_zone:ZONE_BITS;			///< Zone. Each zone is a set of adjacent terrain type.  If from & to in the same zone, you can successfully pathfind.  If not,
 														// you still may be able to if you can cross multiple terrain types.
 	UnsignedShort m_aircraftGoal:1; //< This is an aircraft goal cell.
 	UnsignedShort m_pinched:1; //< This cell is surrounded by obstacle cells.
@@ -443,6 +456,26 @@ enum { PATHFIND_QUEUE_LEN=512};
 
 struct TCheckMovementInfo;
 
+/**
+ * Two zones that neighboring cells join in one or more of the zone equivalency tables.
+ */
+struct ZoneLink
+{
+	enum
+	{
+		HIERARCHICAL	= 0x01,
+		TERRAIN				= 0x02,
+		CRUSHER				= 0x04,
+		GROUND_WATER	= 0x08,
+		GROUND_RUBBLE	= 0x10,
+		GROUND_CLIFF	= 0x20
+	};
+
+	zoneStorageType zone1;
+	zoneStorageType zone2;
+	UnsignedByte tables;
+};
+
 /**
  * This class is a helper class for zone manager.  It maintains information regarding the
  * LocomotorSurfaceTypeMask equivalencies within a ZONE_BLOCK_SIZE x ZONE_BLOCK_SIZE area of
@@ -466,6 +499,11 @@ public:
 	Bool getInteractsWithBridge(void) const {return m_interactsWithBridge;}
 	void setInteractsWithBridge(Bool interacts) {m_interactsWithBridge = interacts;}
 
+	Bool isDirty(void) const {return m_dirty;}
+	void setDirty(Bool dirty) {m_dirty = dirty;}
+
+	std::vector<ZoneLink> &getZoneLinks(void) {return m_zoneLinks;}
+
 protected:
 	void allocateZones(void);
 	void freeZones(void);
@@ -485,6 +523,8 @@ protected:
 	zoneStorageType *m_crusherZones;
 	Bool					m_interactsWithBridge;
 	Bool					m_markedPassable;
+	Bool					m_dirty;						///< Cells changed since the zones were calculated.
+	std::vector<ZoneLink> m_zoneLinks;	///< Links of the cells in this block to each other and to the cells left and above.
 };
 typedef ZoneBlock *ZoneBlockP;
 
@@ -502,6 +542,7 @@ public:
 	enum {INITIAL_ZONES = 256};
 	enum {ZONE_BLOCK_SIZE = 10};	// Zones are calculated in blocks of 20x20.  This way, the raw zone numbers can be used to
 	enum {UNINITIALIZED_ZONE = 0};
+	enum {MAX_ZONES = 24000};
 																// compute hierarchically between the 20x20 blocks of cells. jba.
 	PathfindZoneManager();
 	~PathfindZoneManager();
@@ -512,6 +553,8 @@ public:
  	void markZonesDirty( Bool insert ) ; ///< Called when the zones need to be recalculated.
  	void updateZonesForModify( PathfindCell **map,  PathfindLayer layers[], const IRegion2D &structureBounds, const IRegion2D &globalBounds ) ; ///< Called to recalculate an area when a structure has been removed.
 	void calculateZones(	PathfindCell **map, PathfindLayer layers[], const IRegion2D &bounds);	///< Does zone calculations.
+	Bool hasDirtyBlocks(void) const {return !m_dirtyBlocks.empty();}
+	void updateDirtyBlocks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds );	///< Recalculates the blocks changed by updateZonesForModify.
 	zoneStorageType getEffectiveZone(LocomotorSurfaceTypeMask acceptableSurfaces, Bool crusher, zoneStorageType zone) const;
 	zoneStorageType getEffectiveTerrainZone(zoneStorageType zone) const;
 
@@ -533,10 +576,49 @@ public:
 	void setBridge(Int cellX, Int cellY, Bool bridge);
 	Bool interactsWithBridge(Int cellX, Int cellY) const;
 
+	/// Identifies a hierarchical route by the zones of the start and goal blocks, so that all
+	/// units moving between the same two places share it.
+	struct RouteKey
+	{
+		ICoord2D startBlock;
+		ICoord2D goalBlock;
+		zoneStorageType startZone;
+		zoneStorageType goalZone;
+		PathfindLayerEnum startLayer;
+		PathfindLayerEnum goalLayer;
+		LocomotorSurfaceTypeMask surfaces;
+		Bool isHuman;
+		Bool crusher;
+		Bool closestOK;
+
+		Bool operator==(const RouteKey &other) const;
+	};
+
+	Bool applyCachedRoute(const RouteKey &key, Bool &found);	///< Marks the blocks of a cached route passable. Returns false if it isn't cached.
+	void cacheRoute(const RouteKey &key, Bool found);	///< Caches the blocks currently marked passable as the route for key.
+	void clearRouteCache(void);
+	void setRouteCacheBypassed(Bool bypassed) { m_isRouteCacheBypassed = bypassed; }	///< While bypassed, routes are neither found in nor added to the cache.
+
 private:
 	void allocateZones(void);
 	void freeZones(void);
 	void freeBlocks(void);
+	void updateRouteCacheFrame(void);
+
+	void getBlockBounds(const IRegion2D &globalBounds, Int xBlock, Int yBlock, IRegion2D &bounds) const;
+	void markBlockDirty(Int xBlock, Int yBlock);
+	void calculateBlockCellZones(PathfindCell **map, ZoneBlock &block, const IRegion2D &bounds);
+	void calculateBlockLinks(PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds, Int xBlock, Int yBlock);
+	void resolveZoneLinks(void);
+
+	struct CachedRoute
+	{
+		RouteKey key;
+		Bool found;
+		std::vector<ICoord2D> blocks;
+	};
+
+	enum {MAX_CACHED_ROUTES = 16};
 
 private:
 	ZoneBlock			*m_blockOfZoneBlocks;			///< Zone blocks - Info for hierarchical pathfinding at a "blocky" level.
@@ -552,6 +634,15 @@ private:
 	zoneStorageType *m_terrainZones;
 	zoneStorageType *m_crusherZones;
 	zoneStorageType *m_hierarchicalZones;
+
+	std::vector<ICoord2D> m_dirtyBlocks;	///< Blocks changed by updateZonesForModify since the zones were calculated.
+	Bool					m_zoneLinksValid;
+
+	CachedRoute		m_cachedRoutes[MAX_CACHED_ROUTES];	///< Hierarchical routes found this frame.
+	Int						m_numCachedRoutes;
+	Int						m_nextCachedRoute;					///< Route to replace once the cache is full.
+	UnsignedInt		m_routeCacheFrame;
+	Bool					m_isRouteCacheBypassed;
 };
 
 /**
@@ -591,6 +682,8 @@ public:
  */
 class Pathfinder : PathfindServicesInterface, public Snapshot
 {
+	friend class PathfindBenchmark;
+
 // The following routines are private, but available through the doPathfind callback to aiInterface. jba.
 private:
 	virtual Path *findPath( Object *obj, const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *to);	///< Find a short, valid path between given locations
@@ -736,6 +829,9 @@ protected:
 	Path *findHierarchicalPath( Bool isHuman, const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *to, Bool crusher);
 	Path *findClosestHierarchicalPath( Bool isHuman, const LocomotorSet& locomotorSet, const Coord3D *from, const Coord3D *to, Bool crusher);
 	Path *internal_findHierarchicalPath( Bool isHuman, const LocomotorSurfaceTypeMask locomotorSurface, const Coord3D *from, const Coord3D *to, Bool crusher, Bool closestOK);
+	Bool restrictToHierarchicalPath( Bool isHuman, LocomotorSurfaceTypeMask locomotorSurface, const Coord3D *from, const Coord3D *to, Bool crusher, Bool closestOK);
+	Bool getHierarchicalRouteKey( Bool isHuman, LocomotorSurfaceTypeMask locomotorSurface, const Coord3D *from, const Coord3D *to, Bool crusher, Bool closestOK, PathfindZoneManager::RouteKey &key);
+	void setPassableAroundPosition( const Coord3D *pos );
 	void processHierarchicalCell( const ICoord2D &scanCell, const ICoord2D &deltaPathfindCell,
 																PathfindCell *parentCell,
 																PathfindCell *goalCell, zoneStorageType parentZone,
@@ -867,6 +963,9 @@ private:
 	Int						m_queuePRHead;
 	Int						m_queuePRTail;
 	Int						m_cumulativeCellsAllocated;
+	Bool					m_isProcessingQueue;						///< True while the pathfind queue serves a request
+
+	PathfindBenchmark	*m_benchmark;								///< Captures or measures path requests, if enabled
 };
 
 
@@ -974,8 +1073,8 @@ inline Bool PathfindCell::isObstaclePresent( ObjectID objID ) const
 {
 	if (objID != INVALID_ID && (getType() == PathfindCell::CELL_OBSTACLE))
 	{
-		DEBUG_ASSERTCRASH(m_info, ("Should have info to be obstacle."));
-		return (m_info && m_info->m_obstacleID == objID);
+		DEBUG_ASSERTCRASH(hasInfo(), ("Should have info to be obstacle."));
+		return (hasInfo() && getInfo()->m_obstacleID == objID);
 	}
 
 	return false;
@@ -65,6 +65,7 @@ class LoadScreen;
 class WindowLayout;
 class TerrainLogic;
 class GhostObjectManager;
+class XferCRC;
 class CommandButton;
 enum BuildableStatus CPP_11(: Int);
 
@@ -286,6 +287,9 @@ private:
 	void remakeSleepyUpdate();
 	void validateSleepyUpdate() const;
 
+	void xferObjectCRCs( XferCRC *xferCRC );	///< CRC of all objects from their cached CRCs, see m_incrementalObjectCRC
+	void benchmarkXfer( void );								///< Measure saving and CRCing the game state, see m_xferBenchmarkFrame
+
 private:
 
 	/**
@@ -308,6 +312,7 @@ private:
 	UnsignedInt	m_CRC;																			///< Cache of previous CRC value
 	std::map<Int, UnsignedInt> m_cachedCRCs;								///< CRCs we've seen this frame
 	Bool m_shouldValidateCRCs;															///< Should we validate CRCs this frame?
+	UnsignedInt m_incrementalCRCCount;											///< Logic CRCs calculated from cached object CRCs
 	//-----------------------------------------------------------------------------------------------
 
 	//Added By Sadullah Nader
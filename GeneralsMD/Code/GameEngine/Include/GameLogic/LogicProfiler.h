@@ -0,0 +1,118 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// LogicProfiler.h
+// Per frame timings of the game logic subsystems and update modules
+
+#pragma once
+
+#include "Common/NameKeyGenerator.h"
+
+/**
+ * Measures how long every logic frame spends in each subsystem and in the updates of each
+ * update module class, and writes one line per frame and measured item into a CSV file.
+ *
+ * Enable it with -profileLogic, for example combined with -headless -replay. When it is not
+ * enabled, TheLogicProfiler is NULL and each measured scope costs a single test.
+ */
+class LogicProfiler
+{
+public:
+
+	enum Section
+	{
+		SECTION_SCRIPT_ENGINE,
+		SECTION_TERRAIN_LOGIC,
+		SECTION_COMMANDS,
+		SECTION_NORMAL_UPDATES,
+		SECTION_SLEEPY_UPDATES,
+		SECTION_AI,
+		SECTION_BUILD_ASSISTANT,
+		SECTION_PARTITION_MANAGER,
+		SECTION_DESTROY_LIST,
+		SECTION_WEAPON_STORE,
+
+		SECTION_COUNT
+	};
+
+	LogicProfiler();
+	~LogicProfiler();
+
+	Bool init( const AsciiString& filename );	///< Open the CSV file, return false if it can't be written
+
+	void beginFrame( UnsignedInt frame );	///< Write the previous frame and start measuring the given one
+
+	void addSectionTime( Section section, Int64 ticks ) { m_sectionTicks[section] += ticks; ++m_sectionCalls[section]; }
+	void addUpdateTime( NameKeyType moduleNameKey, Int64 ticks );
+
+	void report( void );	///< Write the last frame and print the totals of the game so far, then start over
+
+	static Int64 getTicks( void ) { Int64 ticks; QueryPerformanceCounter((LARGE_INTEGER *)&ticks); return ticks; }
+
+private:
+
+	struct Timing
+	{
+		Timing() : ticks(0), calls(0) {}
+
+		Int64 ticks;
+		Int calls;
+	};
+
+	void writeFrame( void );
+	double ticksToMicroseconds( Int64 ticks ) const { return (double)ticks * m_microsecondsPerTick; }
+
+	FILE *m_file;
+	Bool m_isFrameOpen;
+	UnsignedInt m_frame;
+
+	Int64 m_sectionTicks[SECTION_COUNT];
+	Int m_sectionCalls[SECTION_COUNT];
+
+	std::vector<Timing> m_updates;							///< Indexed by the name key of the update module class
+	std::vector<NameKeyType> m_updatesThisFrame;	///< The update module classes that ran in this frame
+
+	Int64 m_totalSectionTicks[SECTION_COUNT];
+	std::vector<Timing> m_totalUpdates;					///< Indexed by the name key of the update module class
+
+	double m_microsecondsPerTick;
+};
+
+extern LogicProfiler *TheLogicProfiler;
+
+//-------------------------------------------------------------------------------------------------
+/** Adds the time until the end of the scope to a section of TheLogicProfiler, if there is one. */
+//-------------------------------------------------------------------------------------------------
+class LogicProfilerScope
+{
+public:
+	LogicProfilerScope( LogicProfiler::Section section ) : m_section(section)
+	{
+		m_startTicks = TheLogicProfiler != NULL ? LogicProfiler::getTicks() : 0;
+	}
+
+	~LogicProfilerScope()
+	{
+		if (TheLogicProfiler != NULL)
+			TheLogicProfiler->addSectionTime(m_section, LogicProfiler::getTicks() - m_startTicks);
+	}
+
+private:
+	LogicProfiler::Section m_section;
+	Int64 m_startTicks;
+};
@@ -625,6 +625,13 @@ public:
 	inline UnsignedInt getSafeOcclusionFrame(void) { return m_safeOcclusionFrame; }	//< this is an object specific frame at which it's safe to enable building occlusion.
 	inline void	setSafeOcclusionFrame(UnsignedInt frame) { m_safeOcclusionFrame = frame;}
 
+	// The CRC of this object is cached between CRC intervals when TheGlobalData->m_incrementalObjectCRC is set.
+	// Everything that changes the state that Object::crc() covers must mark the object dirty.
+	inline void markCRCDirty(void) { m_isCRCDirty = TRUE; }
+	inline Bool isCRCDirty(void) const { return m_isCRCDirty; }
+	inline UnsignedInt getCachedCRC(void) const { return m_cachedCRC; }
+	inline void setCachedCRC(UnsignedInt crc) { m_cachedCRC = crc; m_isCRCDirty = FALSE; }
+
 	// All of our cheating for radars and power go here.
 	// This is the function that we now call in becomingTeamMember to adjust our power.
 	// If incoming is true, we're working on the incoming player, if its false, we're on the outgoing
@@ -800,6 +807,8 @@ private:
 
 	UnsignedInt										m_safeOcclusionFrame;	///<flag used by occlusion renderer so it knows when objects have exited their production building.
 
+	UnsignedInt										m_cachedCRC;					///< CRC of this object at the last CRC interval it was dirty in
+
 	// --------- BYTE-SIZED THINGS GO HERE
 	Bool													m_isSelectable;
 	Bool													m_modulesReady;
@@ -811,6 +820,7 @@ private:
 	Byte													m_numTriggerAreasActive;
 	Bool													m_singleUseCommandUsed;
 	Bool													m_isReceivingDifficultyBonus;
+	Bool													m_isCRCDirty;						///< m_cachedCRC needs to be calculated again
 
 };  // end class Object
 
@@ -0,0 +1,103 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// PathfindBenchmark.h
+// Capture and playback of pathfind requests for measuring the pathfinder
+
+#pragma once
+
+#include "GameLogic/LocomotorSet.h"
+
+class Object;
+class Path;
+class Pathfinder;
+
+/**
+ * Records the path requests served by the pathfind queue into a file, and plays them back
+ * against the pathfind map of the same logic frame to measure the pathfinder in isolation.
+ *
+ * Capture with -capturePathfinds and measure with -benchmarkPathfinds, both combined with
+ * -headless -replay. The replay rebuilds the identical pathfind map for every frame, so the
+ * captured requests can be repeated for each pathfinder change and compared by path hash.
+ */
+class PathfindBenchmark
+{
+public:
+
+	enum RequestType
+	{
+		REQUEST_FIND_PATH,
+		REQUEST_FIND_CLOSEST_PATH,
+		REQUEST_FIND_HIERARCHICAL_PATH,	///< Not captured, measured for every captured REQUEST_FIND_PATH
+
+		REQUEST_TYPE_COUNT
+	};
+
+	PathfindBenchmark();
+	~PathfindBenchmark();
+
+	/// Open the capture file and/or load the requests to benchmark. Empty filenames are ignored.
+	void init( const AsciiString& captureFilename, const AsciiString& benchmarkFilename );
+
+	Bool isCapturing( void ) const { return m_captureFile != NULL && !m_isRunningRequests; }
+	void captureRequest( RequestType type, const Object *obj, const LocomotorSet& locomotorSet,
+		const Coord3D *from, const Coord3D *to, Bool blocked, Real pathCostMultiplier, Bool moveAllies );
+
+	Bool isBenchmarking( void ) const { return !m_requests.empty(); }
+	void runRequests( Pathfinder *pathfinder, UnsignedInt frame );	///< Run the loaded requests of this frame
+
+	void report( void );	///< Print the results gathered so far and start over
+
+private:
+
+	struct Request
+	{
+		UnsignedInt frame;
+		RequestType type;
+		ObjectID objectID;
+		AsciiString templateName;
+		LocomotorSurfaceTypeMask surfaces;
+		Coord3D from;
+		Coord3D to;
+		Bool blocked;
+		Real pathCostMultiplier;
+		Bool moveAllies;
+	};
+
+	struct Results
+	{
+		Results() : cellsExamined(0), pathsFound(0), pathHash(0) {}
+
+		std::vector<double> seconds;
+		Int cellsExamined;
+		Int pathsFound;
+		UnsignedInt pathHash;
+	};
+
+	Bool loadRequests( const AsciiString& filename );
+	void runRequest( Pathfinder *pathfinder, const Request& request, Object *obj, RequestType type );
+	static UnsignedInt computePathHash( Path *path );
+	static double getSeconds( void );
+
+	FILE *m_captureFile;
+	std::vector<Request> m_requests;
+	size_t m_nextRequest;
+	Int m_requestsSkipped;
+	Results m_results[REQUEST_TYPE_COUNT];
+	Bool m_isRunningRequests;
+};
@@ -44,6 +44,7 @@ class DataChunkInput;
 struct DataChunkInfo;
 class DataChunkOutput;
 class Team;
+class TeamPrototype;
 class Object;
 class ThingTemplate;
 class Player;
@@ -113,6 +114,9 @@ typedef ListAsciiStringCoord3D::iterator ListAsciiStringCoord3DIt;
 
 typedef std::map< AsciiString, Int > ObjectTypeCount;
 
+// TheSuperHackers @performance Maps the name key of a counter, flag or named object to its index.
+typedef std::hash_map< NameKeyType, Int, rts::hash<NameKeyType>, rts::equal_to<NameKeyType> > NameKeyIndexMap;
+
 typedef std::vector<Player *> VectorPlayerPtr;
 typedef VectorPlayerPtr::iterator VectorPlayerPtrIt;
 
@@ -250,6 +254,7 @@ public:
 	virtual void runScript(const AsciiString& scriptName, Team *pThisTeam=NULL); ///<  Runs a script.
 	virtual void runObjectScript(const AsciiString& scriptName, Object *pThisObject=NULL); ///<  Runs a script attached to this object.
 	virtual Team *getTeamNamed(const AsciiString& teamName); ///<  Gets the named team.  May be null.
+	Team *getTeamFromParam(Parameter *pTeamParm); ///< Same as getTeamNamed, keeps the team prototype in the parameter.
 	virtual Player *getSkirmishEnemyPlayer(void); ///< Gets the ai's enemy Human player. May be null.
 	virtual Player *getCurrentPlayer(void); ///<  Gets the player that owns the current script.  May be null.
 	virtual Player *getPlayerFromAsciiString(const AsciiString& skirmishPlayerString);
@@ -266,10 +271,12 @@ public:
 	// NOTE NOTE NOTE: do not store of the return value of this call (getObjectTypeList) beyond the life of the
 	// function it will be used in, as it can be deleted from under you if maintenance is performed on the object.
 	virtual ObjectTypes *getObjectTypes(const AsciiString& objectTypeList);
+	ObjectTypes *getObjectTypesFromParam(Parameter *pTypeParm); ///< Same as getObjectTypes, keeps the list in the parameter.
 	virtual void doObjectTypeListMaintenance(const AsciiString& objectTypeList, const AsciiString& objectType, Bool addObject);
 
 	/// Return the trigger area with the given name
 	virtual PolygonTrigger *getQualifiedTriggerAreaByName( AsciiString name );
+	PolygonTrigger *getQualifiedTriggerAreaFromParam( Parameter *pTriggerParm ); ///< Same as getQualifiedTriggerAreaByName, keeps the trigger area in the parameter.
 
 	// For other systems to evaluate Conditions, execute Actions, etc.
 
@@ -348,6 +355,9 @@ public:
 
 	//Kris: Moved to public... so that I can refresh it when building abilities in script dialogs.
 	void createNamedCache( void );
+	void rebuildNamedObjectIndex( void );
+	void rebuildCounterAndFlagIndex( void );
+	Int findNamedObjectIndex( const AsciiString& unitName ) const;
 
 	///Begin VTUNE
 	void setEnableVTune(Bool value);
@@ -422,6 +432,9 @@ protected:
 	Bool hasUnitCompletedSequentialScript( Object *object, const AsciiString& sequentialScriptName );
 	Bool hasTeamCompletedSequentialScript( Team *team, const AsciiString& sequentialScriptName );
 
+	Bool getTeamAlias( const AsciiString& teamName, Team **team ); ///< Resolves teamThePlayer, THIS_TEAM and the calling/condition team.
+	Team *getTeamFromPrototype( TeamPrototype *teamProto, const AsciiString& teamName );
+
 
 
 
@@ -432,6 +445,8 @@ protected:
 	Int								m_numCounters;
 	TFlag							m_flags[MAX_FLAGS];
 	Int								m_numFlags;
+	NameKeyIndexMap		m_counterIndex;				///< Index into m_counters by counter name
+	NameKeyIndexMap		m_flagIndex;					///< Index into m_flags by flag name
 	AttackPriorityInfo m_attackPriorityInfo[MAX_ATTACK_PRIORITIES];
 	Int								m_numAttackInfo;
 	Int								m_endGameTimer;
@@ -441,6 +456,7 @@ protected:
 	Team							*m_conditionTeam;				///< Team that is being used to evaluate conditions, used for THIS_TEAM
 	Object						*m_conditionObject;				///< Unit that is being used to evaluate conditions, used for THIS_OBJECT
 	VecNamedRequests	m_namedObjects;
+	NameKeyIndexMap		m_namedObjectIndex;		///< Index into m_namedObjects of the first entry with a name
 	Bool							m_firstUpdate;
 	Player						*m_currentPlayer;
 	Player						*m_skirmishHumanPlayer;
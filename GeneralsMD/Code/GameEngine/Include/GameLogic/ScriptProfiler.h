@@ -0,0 +1,99 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ScriptProfiler.h
+// Timings of the individual scripts and of the script condition and action types
+
+#pragma once
+
+#include "GameLogic/LogicProfiler.h"
+#include "GameLogic/Scripts.h"
+
+/**
+ * Measures how long each script takes to evaluate its conditions and to execute, and how long
+ * each condition and action type takes. The totals are printed sorted by cost and written to a
+ * CSV file when the game ends.
+ *
+ * Enable it with -profileScripts, for example combined with -headless -replay. When it is not
+ * enabled, TheScriptProfiler is NULL and each measured scope costs a single test.
+ */
+class ScriptProfiler
+{
+public:
+
+	ScriptProfiler();
+	~ScriptProfiler();
+
+	Bool init( const AsciiString& filename );	///< Open the CSV file, return false if it can't be written
+
+	void beginFrame( void ) { ++m_frames; }	///< Count a script engine update
+
+	void addScriptTime( const Script *script, Int64 ticks );	///< Executing the script, including its conditions and actions
+	void addScriptConditionTime( const Script *script, Int64 ticks );	///< Evaluating the conditions of the script
+	void addConditionTime( Int conditionType, Int64 ticks ) { addTime(m_conditions[conditionType], ticks); }
+	void addActionTime( Int actionType, Int64 ticks ) { addTime(m_actions[actionType], ticks); }
+
+	void report( void );	///< Print and write the totals of the game so far, then start over
+
+private:
+
+	struct Timing
+	{
+		Timing() : ticks(0), maxTicks(0), calls(0) {}
+
+		Int64 ticks;
+		Int64 maxTicks;
+		Int calls;
+	};
+
+	struct ScriptTiming
+	{
+		AsciiString name;
+		Timing total;
+		Timing conditions;
+	};
+
+	typedef std::map< const Script *, Int, std::less<const Script *> > ScriptIndexMap;
+
+	static void addTime( Timing& timing, Int64 ticks )
+	{
+		timing.ticks += ticks;
+		if (ticks > timing.maxTicks)
+			timing.maxTicks = ticks;
+		++timing.calls;
+	}
+
+	ScriptTiming& getScriptTiming( const Script *script );
+
+	/// The conditions are part of the total, unless the script was only evaluated for its team.
+	static const Timing& getReportedTiming( const ScriptTiming& timing ) { return timing.total.calls != 0 ? timing.total : timing.conditions; }
+	double ticksToMicroseconds( Int64 ticks ) const { return (double)ticks * m_microsecondsPerTick; }
+	void writeTiming( const char *kind, const char *name, const Timing& timing );
+
+	FILE *m_file;
+	UnsignedInt m_frames;
+
+	ScriptIndexMap m_scriptIndex;
+	std::vector<ScriptTiming> m_scripts;
+	Timing m_conditions[Condition::NUM_ITEMS];
+	Timing m_actions[ScriptAction::NUM_ITEMS];
+
+	double m_microsecondsPerTick;
+};
+
+extern ScriptProfiler *TheScriptProfiler;
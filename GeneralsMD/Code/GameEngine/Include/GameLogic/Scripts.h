@@ -798,7 +798,9 @@ public:
 		m_initialized(false),
 		m_paramType(type),
 		m_int(val),
-		m_real(0)
+		m_real(0),
+		m_boundHandle(NULL),
+		m_boundHandleGeneration(0)
 	{
 		m_coord.x=0;m_coord.y=0;m_coord.z=0;
 	}
@@ -812,11 +814,19 @@ private:
 	Coord3D				m_coord;
 	ObjectStatusMaskType m_objectStatus;
 
+	// TheSuperHackers @performance The trigger area, team prototype or object types list that m_string
+	// was last resolved to by the script engine. It is only valid while m_boundHandleGeneration matches
+	// s_boundHandleGeneration.
+	void					*m_boundHandle;
+	UnsignedInt		m_boundHandleGeneration;
+
+	static UnsignedInt s_boundHandleGeneration;
+
 protected:
 	void setInt(Int i) {m_int = i;}
 	void setReal(Real r) {m_real = r;}
 	void setCoord3D(const Coord3D *pLoc);
-	void setString(AsciiString s) {m_string = s;}
+	void setString(AsciiString s) {m_string = s;m_boundHandleGeneration = 0;}
 	void setStatus( ObjectStatusMaskType objectStatus ) { m_objectStatus.set( objectStatus ); }
 
 public:
@@ -829,7 +839,15 @@ public:
 	void friend_setInt(Int i) {m_int = i;}
 	void friend_setReal(Real r) {m_real = r;}
 	void friend_setCoord3D(const Coord3D *pLoc) { setCoord3D(pLoc); }
-	void friend_setString(AsciiString s) {m_string = s;}
+	void friend_setString(AsciiString s) {m_string = s;m_boundHandleGeneration = 0;}
+
+	/// Return the handle that the string was resolved to, if it is still valid.
+	Bool friend_getBoundHandle(void **handle) const { *handle = m_boundHandle; return m_boundHandleGeneration == s_boundHandleGeneration; }
+	void friend_setBoundHandle(void *handle) { m_boundHandle = handle; m_boundHandleGeneration = s_boundHandleGeneration; }
+
+	/// Drop the bound handles of all parameters. Call this whenever trigger areas, team prototypes or
+	/// object types lists are added or removed.
+	static void invalidateBoundHandles(void) { ++s_boundHandleGeneration; }
 
 	void qualify(const AsciiString& qualifier,const AsciiString& playerTemplateName,const AsciiString& newPlayerName);
 
@@ -443,6 +443,28 @@ Int parseReplay(char *args[], int num)
 	return 1;
 }
 
+Int parseReplayWorker(char *args[], int num)
+{
+	TheWritableGlobalData->m_simulateReplayWorker = TRUE;
+
+	TheWritableGlobalData->m_playIntro = FALSE;
+	TheWritableGlobalData->m_afterIntro = TRUE;
+	TheWritableGlobalData->m_playSizzle = FALSE;
+	TheWritableGlobalData->m_shellMapOn = FALSE;
+
+	// Make replay playback possible while other clients (possible retail) are running
+	rts::ClientInstance::setMultiInstance(TRUE);
+	rts::ClientInstance::skipPrimaryInstance();
+
+	return 1;
+}
+
+Int parsePersistentJobs(char *args[], int num)
+{
+	TheWritableGlobalData->m_simulateReplaysInPersistentJobs = TRUE;
+	return 1;
+}
+
 Int parseJobs(char *args[], int num)
 {
 	if (num > 1)
@@ -458,6 +480,104 @@ Int parseJobs(char *args[], int num)
 	return 1;
 }
 
+Int parseCapturePathfinds(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_pathfindCaptureFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkPathfinds(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_pathfindBenchmarkFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkXfer(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_xferBenchmarkFrame = atoi(args[1]);
+		return 2;
+	}
+	return 1;
+}
+
+Int parseProfileLogic(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_logicProfileFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseProfileScripts(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_scriptProfileFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseMemoryPoolProfile(char *args[], int num)
+{
+	if (num > 1)
+	{
+		// The pools are created during engine init, so size them right away.
+		if (!userMemoryManagerReadPoolProfile(args[1]))
+		{
+			printf("Cannot read memory pool profile \"%s\"\n", args[1]);
+		}
+		return 2;
+	}
+	return 1;
+}
+
+Int parseArchiveCache(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_archiveCacheFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseWriteMemoryPoolProfile(char *args[], int num)
+{
+	if (num > 1)
+	{
+		TheWritableGlobalData->m_memoryPoolProfileFile = args[1];
+		return 2;
+	}
+	return 1;
+}
+
+Int parseBenchmarkMemoryPools(char *args[], int)
+{
+	TheWritableGlobalData->m_benchmarkMemoryPools = TRUE;
+	return 1;
+}
+
+#if !RETAIL_COMPATIBLE_CRC
+Int parseIncrementalCRC(char *args[], int)
+{
+	TheWritableGlobalData->m_incrementalObjectCRC = TRUE;
+	return 1;
+}
+#endif
+
 Int parseXRes(char *args[], int num)
 {
 	if (num > 1)
@@ -1163,6 +1283,19 @@ static CommandLineParam paramsForStartup[] =
 	// (If you have 4 cores, call it with -jobs 4)
 	// If you do not call this, all replays will be simulated in sequence in the same process.
 	{ "-jobs", parseJobs },
+
+	// Keep each of the -jobs processes alive and send it one replay after another, so that the game data
+	// is only loaded once per process instead of once per replay. Requires -headless.
+	{ "-persistentJobs", parsePersistentJobs },
+
+	// Used internally by -persistentJobs. Simulates the replays that are received on the standard input.
+	{ "-replayWorker", parseReplayWorker },
+
+	// Size the memory pools from a profile written by -writeMemoryPoolProfile
+	{ "-memoryPoolProfile", parseMemoryPoolProfile },
+
+	// Take the directories of the BIG files that did not change from the given cache file, and write it when any did
+	{ "-archiveCache", parseArchiveCache },
 };
 
 // These Params are parsed during Engine Init before INI data is loaded
@@ -1183,6 +1316,38 @@ static CommandLineParam paramsForEngineInit[] =
 	// TheSuperHackers @feature xezon 03/08/2025 Force full viewport for 'Control Bar Pro' Addons like GenTool did it.
 	{ "-forcefullviewport", parseFullViewport },
 
+	// Write all path requests of the pathfind queue to the given file. Combine this with -headless -replay
+	{ "-capturePathfinds", parseCapturePathfinds },
+
+	// Repeat the path requests of a file written by -capturePathfinds at their frame and print their timings,
+	// examined cells and path hashes when the game ends. Combine this with -headless and the same -replay
+	{ "-benchmarkPathfinds", parseBenchmarkPathfinds },
+
+	// Write the time that every logic frame spends in each subsystem and update module class to the given CSV file,
+	// and print the totals when the game ends. Combine this with -headless -replay
+	{ "-profileLogic", parseProfileLogic },
+
+	// Write the time of every script and of every script condition and action type to the given CSV file, sorted by
+	// cost, and print the most expensive ones when the game ends. Combine this with -headless -replay
+	{ "-profileScripts", parseProfileScripts },
+
+	// Save the game state and calculate its CRC a number of times when the logic reaches the given frame, and print
+	// the timings. Combine this with -headless -replay
+	{ "-benchmarkXfer", parseBenchmarkXfer },
+
+	// Allocate and free lots of blocks in every memory pool after startup, print the timings and exit. Combine this with -headless
+	{ "-benchmarkMemoryPools", parseBenchmarkMemoryPools },
+
+	// Write the peak block count of every memory pool to the given profile when the game exits. Peaks that the file
+	// already has are kept if they are higher, so that a batch of runs accumulates one profile. Combine this with -headless -replay
+	{ "-writeMemoryPoolProfile", parseWriteMemoryPoolProfile },
+
+#if !RETAIL_COMPATIBLE_CRC
+	// Calculate the CRC of only the objects that changed since the last CRC interval. The CRCs differ from games
+	// without it, so every player of a game must use it, and replays must be played with the setting they were recorded with
+	{ "-incrementalCRC", parseIncrementalCRC },
+#endif
+
 #if defined(RTS_DEBUG)
 	{ "-noaudio", parseNoAudio },
 	{ "-map", parseMapName },
@@ -42,16 +42,32 @@ Int GameMain()
 	TheGameEngine = CreateGameEngine();
 	TheGameEngine->init();
 
-	if (!TheGlobalData->m_simulateReplays.empty())
+	if (TheGlobalData->m_simulateReplayWorker)
+	{
+		exitcode = ReplaySimulation::simulateReplaysAsWorker();
+	}
+	else if (!TheGlobalData->m_simulateReplays.empty())
 	{
 		exitcode = ReplaySimulation::simulateReplays(TheGlobalData->m_simulateReplays, TheGlobalData->m_simulateReplayJobs);
 	}
+	else if (TheGlobalData->m_benchmarkMemoryPools)
+	{
+		exitcode = TheMemoryPoolFactory->memoryPoolBenchmark();
+	}
 	else
 	{
 		// run it
 		TheGameEngine->execute();
 	}
 
+	if (TheGlobalData->m_memoryPoolProfileFile.isNotEmpty())
+	{
+		if (!userMemoryManagerWritePoolProfile(TheGlobalData->m_memoryPoolProfileFile.str()))
+		{
+			printf("Cannot write memory pool profile \"%s\"\n", TheGlobalData->m_memoryPoolProfileFile.str());
+		}
+	}
+
 	// since execute() returned, we are exiting the game
 	delete TheGameEngine;
 	TheGameEngine = NULL;
@@ -967,6 +967,18 @@ GlobalData::GlobalData()
 
 	m_simulateReplays.clear();
 	m_simulateReplayJobs = SIMULATE_REPLAYS_SEQUENTIAL;
+	m_simulateReplaysInPersistentJobs = FALSE;
+	m_simulateReplayWorker = FALSE;
+
+	m_pathfindCaptureFile.clear();
+	m_pathfindBenchmarkFile.clear();
+	m_logicProfileFile.clear();
+	m_scriptProfileFile.clear();
+	m_benchmarkMemoryPools = FALSE;
+	m_memoryPoolProfileFile.clear();
+	m_archiveCacheFile.clear();
+	m_incrementalObjectCRC = FALSE;
+	m_xferBenchmarkFrame = 0;
 
 	for (i = LEVEL_FIRST; i <= LEVEL_LAST; ++i)
 		m_healthBonus[i] = 1.0f;
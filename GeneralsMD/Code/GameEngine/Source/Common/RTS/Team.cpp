@@ -207,6 +207,7 @@ void TeamFactory::clear()
 		// the TeamProto will try to remove itself from the list when it goes away
 	TeamPrototypeMap tmp = m_prototypes;
 	m_prototypes.clear();
+	Parameter::invalidateBoundHandles();
 	for (TeamPrototypeMap::iterator it = tmp.begin(); it != tmp.end(); ++it)
 	{
 		deleteInstance(it->second);
@@ -258,6 +259,7 @@ void TeamFactory::addTeamPrototypeToList(TeamPrototype* team)
 	}
 
 	m_prototypes[nk] = team;
+	Parameter::invalidateBoundHandles();
 }
 
 //=============================================================================
@@ -267,6 +269,7 @@ void TeamFactory::removeTeamPrototypeFromList(TeamPrototype* team)
 	TeamPrototypeMap::iterator it = m_prototypes.find(nk);
 	if (it != m_prototypes.end())
 		m_prototypes.erase(it);
+	Parameter::invalidateBoundHandles();
 }
 
 // ------------------------------------------------------------------------
@@ -351,29 +351,25 @@ void Particle::applyForce( const Coord3D *force )
 // ------------------------------------------------------------------------------------------------
 /** Update the behavior of an individual particle */
 // ------------------------------------------------------------------------------------------------
-Bool Particle::update( void )
+Bool Particle::update( const ParticleUpdateContext& context )
 {
-	// integrate acceleration into velocity
+	// integrate acceleration and 'gravity' into velocity
 	m_vel.x += m_accel.x;
 	m_vel.y += m_accel.y;
-	m_vel.z += m_accel.z;
+	m_vel.z += m_accel.z + context.gravity;
 
 	m_vel.x *= m_velDamping;
 	m_vel.y *= m_velDamping;
 	m_vel.z *= m_velDamping;
 
 	// integrate velocity into position
-	const Coord3D *driftVel = m_system->getDriftVelocity();
-	m_pos.x += m_vel.x + driftVel->x;
-	m_pos.y += m_vel.y + driftVel->y;
-	m_pos.z += m_vel.z + driftVel->z;
+	m_pos.x += m_vel.x + context.driftVelocity.x;
+	m_pos.y += m_vel.y + context.driftVelocity.y;
+	m_pos.z += m_vel.z + context.driftVelocity.z;
 
 	// integrate the wind (if specified) into position
-	ParticleSystemInfo::WindMotion windMotion = m_system->getWindMotion();
-
-	// see if we should even do anything
-	if( windMotion != ParticleSystemInfo::WIND_MOTION_NOT_USED )
-		doWindMotion();
+	if( context.useWind )
+		doWindMotion( context );
 
 	// update orientation
 	m_angleZ += m_angularRateZ;
@@ -398,13 +394,13 @@ Bool Particle::update( void )
 	// Update alpha (if used)
 	//
 
-	if (m_system->getShaderType() != ParticleSystemInfo::ADDITIVE)
+	if (context.shaderType != ParticleSystemInfo::ADDITIVE)
 	{
 		m_alpha += m_alphaRate;
 
 		if (m_alphaTargetKey < MAX_KEYFRAMES && m_alphaKey[ m_alphaTargetKey ].frame)
 		{
-			if (TheGameClient->getFrame() - m_createTimestamp >= m_alphaKey[ m_alphaTargetKey ].frame)
+			if (context.frame - m_createTimestamp >= m_alphaKey[ m_alphaTargetKey ].frame)
 			{
 				m_alpha = m_alphaKey[ m_alphaTargetKey ].value;
 				m_alphaTargetKey++;
@@ -430,7 +426,7 @@ Bool Particle::update( void )
 
 	if (m_colorTargetKey < MAX_KEYFRAMES && m_colorKey[ m_colorTargetKey ].frame)
 	{
-		if (TheGameClient->getFrame() - m_createTimestamp >= m_colorKey[ m_colorTargetKey ].frame)
+		if (context.frame - m_createTimestamp >= m_colorKey[ m_colorTargetKey ].frame)
 		{
 			// can't set, because of colorscale
 			// m_color = m_colorKey[ m_colorTargetKey ].color;
@@ -484,56 +480,17 @@ Bool Particle::update( void )
 // ------------------------------------------------------------------------------------------------
 /** Do wind motion as specified by the particle system template, if present */
 // ------------------------------------------------------------------------------------------------
-void Particle::doWindMotion( void )
+void Particle::doWindMotion( const ParticleUpdateContext& context )
 {
 
-	// get the angle of the wind
-	Real windAngle = m_system->getWindAngle();
-
-	// get the system position
-	Coord3D systemPos;
-	m_system->getPosition( &systemPos );
-
-	// when we're attached objects and drawables we offset by that position as well
-	if( ObjectID attachedObj = m_system->getAttachedObject() )
-	{
-		Object *obj = TheGameLogic->findObjectByID( attachedObj );
-
-		if( obj )
-		{
-			const Coord3D *objPos = obj->getPosition();
-
-			systemPos.x += objPos->x;
-			systemPos.y += objPos->y;
-			systemPos.z += objPos->z;
-
-		}  // end if
-
-	}  // end if
-	else if( DrawableID attachedDraw = m_system->getAttachedDrawable() )
-	{
-		Drawable *draw = TheGameClient->findDrawableByID( attachedDraw );
-
-		if( draw )
-		{
-			const Coord3D *drawPos = draw->getPosition();
-
-			systemPos.x += drawPos->x;
-			systemPos.y += drawPos->y;
-			systemPos.z += drawPos->z;
-
-		}  // end if
-
-	}  // end else if
-
 	//
 	// compute a vector from the system position in the world to the particle ... we will use
 	// this to compute how much force we apply
 	//
 	Coord3D v;
-	v.x = m_pos.x - systemPos.x;
-	v.y = m_pos.y - systemPos.y;
-	v.z = m_pos.z - systemPos.z;
+	v.x = m_pos.x - context.windPos.x;
+	v.y = m_pos.y - context.windPos.y;
+	v.z = m_pos.z - context.windPos.z;
 
 	// distance amounts for full force from wind and no force at all
 	Real fullForceDistance = 75.0f;
@@ -556,8 +513,8 @@ void Particle::doWindMotion( void )
 																		(noForceDistance - fullForceDistance)));
 
 		// integate the wind motion into the position
-		m_pos.x += (Cos( windAngle ) * windForceStrength);
-		m_pos.y += (Sin( windAngle ) * windForceStrength);
+		m_pos.x += (context.windCos * windForceStrength);
+		m_pos.y += (context.windSin * windForceStrength);
 
 	}  // end if
 
@@ -2048,22 +2005,14 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 	//
 	// Update all particles in the system
 	//
+	ParticleUpdateContext context;
+	computeParticleUpdateContext( &context );
+
 	Particle *p = m_systemParticlesHead;
 	Particle *oldParticle;
 	while (p)
 	{
-
-		// apply 'gravity' force
-		if (m_gravity != 0.0f)
-		{
-			Coord3D force;
-			force.x = 0.0f;
-			force.y = 0.0f;
-			force.z = m_gravity;
-			p->applyForce( &force );
-		}
-
-		if (p->update() == false)
+		if (p->update( context ) == false)
 		{
 			oldParticle = p;
 			p = p->m_systemNext;
@@ -2100,6 +2049,60 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 	return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+/** Compute the values that are the same for all particles of this system in this frame */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::computeParticleUpdateContext( ParticleUpdateContext *context )
+{
+	context->driftVelocity = m_driftVelocity;
+	context->gravity = m_gravity;
+	context->shaderType = m_shaderType;
+	context->frame = TheGameClient->getFrame();
+
+	context->useWind = (m_windMotion != ParticleSystemInfo::WIND_MOTION_NOT_USED);
+	if (context->useWind == false)
+		return;
+
+	// get the system position
+	getPosition( &context->windPos );
+
+	// when we're attached objects and drawables we offset by that position as well
+	if( m_attachedToObjectID )
+	{
+		Object *obj = TheGameLogic->findObjectByID( m_attachedToObjectID );
+
+		if( obj )
+		{
+			const Coord3D *objPos = obj->getPosition();
+
+			context->windPos.x += objPos->x;
+			context->windPos.y += objPos->y;
+			context->windPos.z += objPos->z;
+
+		}  // end if
+
+	}  // end if
+	else if( m_attachedToDrawableID )
+	{
+		Drawable *draw = TheGameClient->findDrawableByID( m_attachedToDrawableID );
+
+		if( draw )
+		{
+			const Coord3D *drawPos = draw->getPosition();
+
+			context->windPos.x += drawPos->x;
+			context->windPos.y += drawPos->y;
+			context->windPos.z += drawPos->z;
+
+		}  // end if
+
+	}  // end else if
+
+	// get the direction of the wind
+	context->windCos = Cos( m_windAngle );
+	context->windSin = Sin( m_windAngle );
+}
+
 // ------------------------------------------------------------------------------------------------
 /** Update the wind motion */
 // ------------------------------------------------------------------------------------------------
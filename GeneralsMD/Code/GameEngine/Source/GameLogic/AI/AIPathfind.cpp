@@ -47,6 +47,7 @@
 #include "GameLogic/Module/PhysicsUpdate.h"
 #include "GameLogic/Object.h"
 #include "GameLogic/PartitionManager.h"
+#include "GameLogic/PathfindBenchmark.h"
 #include "GameLogic/TerrainLogic.h"
 #include "GameLogic/Weapon.h"
 
@@ -1098,6 +1099,127 @@ Real Path::computeFlightDistToGoal( const Coord3D *pos, Coord3D& goalPos )
 
 enum { PATHFIND_CELLS_PER_FRAME=5000}; // Number of cells we will search pathfinding per frame.
 enum {CELL_INFOS_TO_ALLOCATE = 30000};
+// PathfindCell refers to its info by a 16 bit index, of which 0xffff means no info.
+static_assert(CELL_INFOS_TO_ALLOCATE < 0xffff, "PathfindCell info index is too small");
+
+//-----------------------------------------------------------------------------------
+
+static inline Int highestBitIndex(UnsignedInt bits)
+{
+	DEBUG_ASSERTCRASH(bits != 0, ("Need at least one bit set."));
+	Int index = 0;
+	if (bits & 0xFFFF0000) { bits >>= 16; index += 16; }
+	if (bits & 0xFF00) { bits >>= 8; index += 8; }
+	if (bits & 0xF0) { bits >>= 4; index += 4; }
+	if (bits & 0xC) { bits >>= 2; index += 2; }
+	if (bits & 0x2) { index += 1; }
+	return index;
+}
+
+/**
+ * Radix index into the sorted A* "open" list, so a cell can be inserted without walking the list.
+ * For every total cost present on the open list, it remembers the last cell with that cost, and a
+ * two level bitmap finds the closest cost that is less than or equal to a given one.
+ * Inserting a cell after the last cell with a cost less or equal than its own is exactly what the
+ * insertion sort of the open list did, so cells still come off the open list in the same order.
+ */
+class PathfindOpenListIndex
+{
+public:
+	PathfindOpenListIndex() { reset(); }
+
+	void reset(void)
+	{
+		memset(m_lastCell, 0, sizeof(m_lastCell));
+		memset(m_costBits, 0, sizeof(m_costBits));
+		memset(m_wordBits, 0, sizeof(m_wordBits));
+		m_count = 0;
+	}
+
+	/// Forget all cells. Only the costs in use are touched, as a cost has a last cell exactly when its bit is set.
+	void clear(void)
+	{
+		Int summary;
+		for (summary = 0; summary < NUM_SUMMARY_WORDS; ++summary)
+		{
+			UnsignedInt words = m_wordBits[summary];
+			while (words != 0)
+			{
+				const Int word = (summary << 5) + highestBitIndex(words);
+				words &= ~(1u << (word & 31));
+				UnsignedInt bits = m_costBits[word];
+				while (bits != 0)
+				{
+					const Int cost = (word << 5) + highestBitIndex(bits);
+					bits &= ~(1u << (cost & 31));
+					m_lastCell[cost] = NULL;
+				}
+				m_costBits[word] = 0;
+			}
+			m_wordBits[summary] = 0;
+		}
+		m_count = 0;
+	}
+
+	Bool isEmpty(void) const { return m_count == 0; }
+
+	/// Return the last cell on the open list with a cost less or equal than cost, or NULL if there is none.
+	PathfindCell *findLastCell(UnsignedShort cost) const
+	{
+		Int word = cost >> 5;
+		UnsignedInt bits = m_costBits[word] & (0xFFFFFFFF >> (31 - (cost & 31)));
+		if (bits == 0)
+		{
+			Int summary = word >> 5;
+			UnsignedInt words = m_wordBits[summary] & ((1u << (word & 31)) - 1);
+			while (words == 0)
+			{
+				if (--summary < 0)
+					return NULL;
+				words = m_wordBits[summary];
+			}
+			word = (summary << 5) + highestBitIndex(words);
+			bits = m_costBits[word];
+		}
+		return m_lastCell[(word << 5) + highestBitIndex(bits)];
+	}
+
+	/// The cell was linked into the open list right after findLastCell(cost).
+	void addCell(PathfindCell *cell, UnsignedShort cost)
+	{
+		m_lastCell[cost] = cell;
+		m_costBits[cost >> 5] |= 1u << (cost & 31);
+		m_wordBits[cost >> 10] |= 1u << ((cost >> 5) & 31);
+		++m_count;
+	}
+
+	/// The cell is about to be unlinked from the open list. prevCell is the cell in front of it, if it has the same cost.
+	void removeCell(PathfindCell *cell, UnsignedShort cost, PathfindCell *prevCellWithSameCost)
+	{
+		DEBUG_ASSERTCRASH(m_count > 0, ("Open list index is out of sync."));
+		--m_count;
+		if (m_lastCell[cost] != cell)
+			return;
+
+		m_lastCell[cost] = prevCellWithSameCost;
+		if (prevCellWithSameCost != NULL)
+			return;
+
+		m_costBits[cost >> 5] &= ~(1u << (cost & 31));
+		if (m_costBits[cost >> 5] == 0)
+			m_wordBits[cost >> 10] &= ~(1u << ((cost >> 5) & 31));
+	}
+
+private:
+	enum { NUM_COSTS = 0x10000, NUM_COST_WORDS = NUM_COSTS / 32, NUM_SUMMARY_WORDS = NUM_COST_WORDS / 32 };
+
+	PathfindCell *m_lastCell[NUM_COSTS];				///< Last cell on the open list for each cost
+	UnsignedInt m_costBits[NUM_COST_WORDS];			///< Bit per cost that has cells on the open list
+	UnsignedInt m_wordBits[NUM_SUMMARY_WORDS];	///< Bit per m_costBits word that is not zero
+	Int m_count;																///< Number of cells on the open list
+};
+
+static PathfindOpenListIndex s_openListIndex;
 PathfindCellInfo *PathfindCellInfo::s_infoArray = NULL;
 PathfindCellInfo *PathfindCellInfo::s_firstFree = NULL;
 /**
@@ -1185,7 +1307,7 @@ void PathfindCellInfo::releaseACellInfo(PathfindCellInfo *theInfo)
 /**
  * Constructor
  */
-PathfindCell::PathfindCell( void ) :m_info(NULL)
+PathfindCell::PathfindCell( void ) :m_infoIndex(NO_CELL_INFO)
 {
 	reset();
 }
@@ -1195,8 +1317,8 @@ PathfindCell::PathfindCell( void ) :m_info(NULL)
  */
 PathfindCell::~PathfindCell( void )
 {
-	if (m_info) PathfindCellInfo::releaseACellInfo(m_info);
-	m_info = NULL;
+	if (hasInfo()) PathfindCellInfo::releaseACellInfo(getInfo());
+	setInfo(NULL);
 	static Bool warn = true;
 	if (warn) {
 		warn = false;
@@ -1214,10 +1336,10 @@ void PathfindCell::reset( )
 	m_zone = 0;
 	m_aircraftGoal = false;
 	m_pinched = false;
-	if (m_info) {
-		m_info->m_obstacleID = INVALID_ID;
-		PathfindCellInfo::releaseACellInfo(m_info);
-		m_info = NULL;
+	if (hasInfo()) {
+		getInfo()->m_obstacleID = INVALID_ID;
+		PathfindCellInfo::releaseACellInfo(getInfo());
+		setInfo(NULL);
 	}
 	m_connectsToLayer = LAYER_INVALID;
 	m_layer = LAYER_GROUND;
@@ -1229,17 +1351,22 @@ void PathfindCell::reset( )
  */
 Bool PathfindCell::startPathfind( PathfindCell *goalCell  )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	m_info->m_nextOpen = NULL;
-	m_info->m_prevOpen = NULL;
-	m_info->m_pathParent = NULL;
-	m_info->m_costSoFar = 0;		// start node, no cost to get here
-	m_info->m_totalCost = 0;
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	getInfo()->m_nextOpen = NULL;
+	getInfo()->m_prevOpen = NULL;
+	getInfo()->m_pathParent = NULL;
+	getInfo()->m_costSoFar = 0;		// start node, no cost to get here
+	getInfo()->m_totalCost = 0;
 	if (goalCell) {
-		m_info->m_totalCost = costToGoal( goalCell );
+		getInfo()->m_totalCost = costToGoal( goalCell );
 	}
-	m_info->m_open = TRUE;
-	m_info->m_closed = FALSE;
+	getInfo()->m_open = TRUE;
+	getInfo()->m_closed = FALSE;
+
+	// This cell is the whole new open list. Searches that returned early may have left cells in the index.
+	s_openListIndex.clear();
+	getInfo()->m_openCost = getInfo()->m_totalCost;
+	s_openListIndex.addCell(this, getInfo()->m_openCost);
 	return true;
 }
 /**
@@ -1247,10 +1374,10 @@ Bool PathfindCell::startPathfind( PathfindCell *goalCell  )
  */
 void PathfindCell::setParentCell( PathfindCell* parent  )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	m_info->m_pathParent = parent->m_info;
-	Int dx = m_info->m_pos.x - parent->m_info->m_pos.x;
-	Int dy = m_info->m_pos.y - parent->m_info->m_pos.y;
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	getInfo()->m_pathParent = parent->getInfo();
+	Int dx = getInfo()->m_pos.x - parent->getInfo()->m_pos.x;
+	Int dy = getInfo()->m_pos.y - parent->getInfo()->m_pos.y;
 	if (dx<-1 || dx>1 || dy<-1 || dy>1) {
 		DEBUG_CRASH(("Invalid parent index."));
 	}
@@ -1261,8 +1388,8 @@ void PathfindCell::setParentCell( PathfindCell* parent  )
  */
 void PathfindCell::setParentCellHierarchical( PathfindCell* parent  )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	m_info->m_pathParent = parent->m_info;
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	getInfo()->m_pathParent = parent->getInfo();
 }
 
 /**
@@ -1270,8 +1397,8 @@ void PathfindCell::setParentCellHierarchical( PathfindCell* parent  )
  */
 void PathfindCell::clearParentCell( void  )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	m_info->m_pathParent = NULL;
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	getInfo()->m_pathParent = NULL;
 }
 
 
@@ -1280,9 +1407,9 @@ void PathfindCell::clearParentCell( void  )
  */
 Bool PathfindCell::allocateInfo( const ICoord2D &pos )
 {
-	if (!m_info) {
-		m_info = PathfindCellInfo::getACellInfo(this, pos);
-		return (m_info != NULL);
+	if (!hasInfo()) {
+		setInfo(PathfindCellInfo::getACellInfo(this, pos));
+		return hasInfo();
 	}
 	return true;
 }
@@ -1302,17 +1429,17 @@ void PathfindCell::releaseInfo( void )
 		return;
 	}
 
-	if (m_info) {
-		DEBUG_ASSERTCRASH(m_info->m_prevOpen==NULL && m_info->m_nextOpen==NULL, ("Shouldn't be linked."));
-		DEBUG_ASSERTCRASH(m_info->m_open==NULL && m_info->m_closed==NULL, ("Shouldn't be linked."));
-		DEBUG_ASSERTCRASH(m_info->m_goalUnitID==INVALID_ID && m_info->m_posUnitID==INVALID_ID, ("Shouldn't be occupied."));
-		DEBUG_ASSERTCRASH(m_info->m_goalAircraftID==INVALID_ID , ("Shouldn't be occupied by aircraft."));
-		if (m_info->m_prevOpen || m_info->m_nextOpen || m_info->m_open || m_info->m_closed) {
+	if (hasInfo()) {
+		DEBUG_ASSERTCRASH(getInfo()->m_prevOpen==NULL && getInfo()->m_nextOpen==NULL, ("Shouldn't be linked."));
+		DEBUG_ASSERTCRASH(getInfo()->m_open==NULL && getInfo()->m_closed==NULL, ("Shouldn't be linked."));
+		DEBUG_ASSERTCRASH(getInfo()->m_goalUnitID==INVALID_ID && getInfo()->m_posUnitID==INVALID_ID, ("Shouldn't be occupied."));
+		DEBUG_ASSERTCRASH(getInfo()->m_goalAircraftID==INVALID_ID , ("Shouldn't be occupied by aircraft."));
+		if (getInfo()->m_prevOpen || getInfo()->m_nextOpen || getInfo()->m_open || getInfo()->m_closed) {
 			// Bad release.  Skip for now, better leak than crash.  jba.
 			return;
 		}
-		PathfindCellInfo::releaseACellInfo(m_info);
-		m_info = NULL;
+		PathfindCellInfo::releaseACellInfo(getInfo());
+		setInfo(NULL);
 	}
 }
 
@@ -1323,9 +1450,9 @@ void PathfindCell::setGoalUnit(ObjectID unitID, const ICoord2D &pos )
 {
 	if (unitID==INVALID_ID) {
 		// removing goal.
-		if (m_info) {
-			m_info->m_goalUnitID = INVALID_ID;
-			if (m_info->m_posUnitID == INVALID_ID) {
+		if (hasInfo()) {
+			getInfo()->m_goalUnitID = INVALID_ID;
+			if (getInfo()->m_posUnitID == INVALID_ID) {
 				// No units here.
 				DEBUG_ASSERTCRASH(m_flags==UNIT_GOAL, ("Bad flags."));
 				m_flags = NO_UNITS;
@@ -1338,18 +1465,18 @@ void PathfindCell::setGoalUnit(ObjectID unitID, const ICoord2D &pos )
 		}
 	} else {
 		// adding goal.
-		if (!m_info) {
+		if (!hasInfo()) {
 			DEBUG_ASSERTCRASH(m_flags == NO_UNITS, ("Bad flags."));
 			allocateInfo(pos);
 		}
-		if (!m_info) {
+		if (!hasInfo()) {
 			DEBUG_CRASH(("Ran out of pathfind cells - fatal error!!!!! jba."));
 			return;
 		}
-		m_info->m_goalUnitID = unitID;
-		if (unitID==m_info->m_posUnitID) {
+		getInfo()->m_goalUnitID = unitID;
+		if (unitID==getInfo()->m_posUnitID) {
 			m_flags = UNIT_PRESENT_FIXED;
-		} else if (m_info->m_posUnitID==INVALID_ID) {
+		} else if (getInfo()->m_posUnitID==INVALID_ID) {
 			m_flags = UNIT_GOAL;
 		}	else {
 			m_flags = UNIT_GOAL_OTHER_MOVING;
@@ -1365,8 +1492,8 @@ void PathfindCell::setGoalAircraft(ObjectID unitID, const ICoord2D &pos )
 {
 	if (unitID==INVALID_ID) {
 		// removing goal.
-		if (m_info) {
-			m_info->m_goalAircraftID = INVALID_ID;
+		if (hasInfo()) {
+			getInfo()->m_goalAircraftID = INVALID_ID;
 			m_aircraftGoal = false;
 			releaseInfo();
 		}	else {
@@ -1374,15 +1501,15 @@ void PathfindCell::setGoalAircraft(ObjectID unitID, const ICoord2D &pos )
 		}
 	} else {
 		// adding goal.
-		if (!m_info) {
+		if (!hasInfo()) {
 			DEBUG_ASSERTCRASH(m_aircraftGoal==false, ("Bad flags."));
 			allocateInfo(pos);
 		}
-		if (!m_info) {
+		if (!hasInfo()) {
 			DEBUG_CRASH(("Ran out of pathfind cells - fatal error!!!!! jba."));
 			return;
 		}
-		m_info->m_goalAircraftID = unitID;
+		getInfo()->m_goalAircraftID = unitID;
 		m_aircraftGoal = true;
 	}
 }
@@ -1395,9 +1522,9 @@ void PathfindCell::setPosUnit(ObjectID unitID, const ICoord2D &pos )
 {
 	if (unitID==INVALID_ID) {
 		// removing position.
-		if (m_info) {
-			m_info->m_posUnitID = INVALID_ID;
-			if (m_info->m_goalUnitID == INVALID_ID) {
+		if (hasInfo()) {
+			getInfo()->m_posUnitID = INVALID_ID;
+			if (getInfo()->m_goalUnitID == INVALID_ID) {
 				// No units here.
 				DEBUG_ASSERTCRASH(m_flags==UNIT_PRESENT_MOVING, ("Bad flags."));
 				m_flags = NO_UNITS;
@@ -1410,22 +1537,22 @@ void PathfindCell::setPosUnit(ObjectID unitID, const ICoord2D &pos )
 		}
 	} else {
 		// adding goal.
-		if (!m_info) {
+		if (!hasInfo()) {
 			DEBUG_ASSERTCRASH(m_flags == NO_UNITS, ("Bad flags."));
 			allocateInfo(pos);
 		}
-		if (!m_info) {
+		if (!hasInfo()) {
 			DEBUG_CRASH(("Ran out of pathfind cells - fatal error!!!!! jba."));
 			return;
 		}
-		if (m_info->m_goalUnitID!=INVALID_ID && (m_info->m_goalUnitID==m_info->m_posUnitID)) {
+		if (getInfo()->m_goalUnitID!=INVALID_ID && (getInfo()->m_goalUnitID==getInfo()->m_posUnitID)) {
 			// A unit is already occupying this cell.
 			return;
 		}
-		m_info->m_posUnitID = unitID;
-		if (unitID==m_info->m_goalUnitID) {
+		getInfo()->m_posUnitID = unitID;
+		if (unitID==getInfo()->m_goalUnitID) {
 			m_flags = UNIT_PRESENT_FIXED;
-		} else if (m_info->m_goalUnitID==INVALID_ID) {
+		} else if (getInfo()->m_goalUnitID==INVALID_ID) {
 			m_flags = UNIT_PRESENT_MOVING;
 		}	else {
 			m_flags = UNIT_GOAL_OTHER_MOVING;
@@ -1452,24 +1579,24 @@ Bool PathfindCell::setTypeAsObstacle( Object *obstacle, Bool isFence, const ICoo
 
 	if (isRubble) {
 		m_type = PathfindCell::CELL_RUBBLE;
-		if (m_info) {
-			m_info->m_obstacleID = INVALID_ID;
+		if (hasInfo()) {
+			getInfo()->m_obstacleID = INVALID_ID;
 			releaseInfo();
 		}
 		return true;
 	}
 
 	m_type = PathfindCell::CELL_OBSTACLE ;
-	if (!m_info) {
-		m_info = PathfindCellInfo::getACellInfo(this, pos);
-		if (!m_info) {
+	if (!hasInfo()) {
+		setInfo(PathfindCellInfo::getACellInfo(this, pos));
+		if (!hasInfo()) {
 			DEBUG_CRASH(("Not enough PathFindCellInfos in pool."));
 			return false;
 		}
 	}
-	m_info->m_obstacleID = obstacle->getID();
-	m_info->m_obstacleIsFence = isFence;
-	m_info->m_obstacleIsTransparent = obstacle->isKindOf(KINDOF_CAN_SEE_THROUGH_STRUCTURE);
+	getInfo()->m_obstacleID = obstacle->getID();
+	getInfo()->m_obstacleIsFence = isFence;
+	getInfo()->m_obstacleIsTransparent = obstacle->isKindOf(KINDOF_CAN_SEE_THROUGH_STRUCTURE);
 	return true;
 }
 
@@ -1478,7 +1605,7 @@ Bool PathfindCell::setTypeAsObstacle( Object *obstacle, Bool isFence, const ICoo
  */
 void PathfindCell::setType( CellType type )
 {
-	if (m_info && (m_info->m_obstacleID != INVALID_ID)) {
+	if (hasInfo() && (getInfo()->m_obstacleID != INVALID_ID)) {
 		DEBUG_ASSERTCRASH(type==PathfindCell::CELL_OBSTACLE, ("Wrong type."));
 		m_type = PathfindCell::CELL_OBSTACLE;
 		return;
@@ -1495,10 +1622,10 @@ Bool PathfindCell::removeObstacle( Object *obstacle )
 	if (m_type == PathfindCell::CELL_RUBBLE) {
 		m_type = PathfindCell::CELL_CLEAR;
 	}
-	if (!m_info) return false;
-	if (m_info->m_obstacleID != obstacle->getID()) return false;
+	if (!hasInfo()) return false;
+	if (getInfo()->m_obstacleID != obstacle->getID()) return false;
 	m_type = PathfindCell::CELL_CLEAR;
-	m_info->m_obstacleID = INVALID_ID;
+	getInfo()->m_obstacleID = INVALID_ID;
 	releaseInfo();
 	return true;
 }
@@ -1506,52 +1633,43 @@ Bool PathfindCell::removeObstacle( Object *obstacle )
 /// put self on "open" list in ascending cost order, return new list
 PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
-	if (list == NULL)
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	DEBUG_ASSERTCRASH(getInfo()->m_closed==FALSE && getInfo()->m_open==FALSE, ("Serious error - Invalid flags. jba"));
+	DEBUG_ASSERTCRASH((list == NULL) == s_openListIndex.isEmpty(), ("Open list index is out of sync."));
+
+	// Insert after the last cell with a cost less or equal than ours, same as an insertion sort
+	// walking the list from the front would.
+	PathfindCell *lastCell = list ? s_openListIndex.findLastCell(getInfo()->m_totalCost) : NULL;
+	if (lastCell == NULL)
 	{
+		// insert at front of list
+		getInfo()->m_prevOpen = NULL;
+		getInfo()->m_nextOpen = list ? list->getInfo() : NULL;
+		if (list)
+			list->getInfo()->m_prevOpen = this->getInfo();
 		list = this;
-		m_info->m_prevOpen = NULL;
-		m_info->m_nextOpen = NULL;
 	}
 	else
 	{
-		// insertion sort
-		PathfindCell *c, *lastCell = NULL;
-		for( c = list; c; c = c->getNextOpen() )
-		{
-			if (c->m_info->m_totalCost > m_info->m_totalCost)
-				break;
-
-			lastCell = c;
-		}
-
-		if (c)
-		{
-			// insert just before "c"
-			if (c->m_info->m_prevOpen)
-				c->m_info->m_prevOpen->m_nextOpen = this->m_info;
-			else
-				list = this;
+		// insert just after "lastCell"
+		getInfo()->m_prevOpen = lastCell->getInfo();
+		getInfo()->m_nextOpen = lastCell->getInfo()->m_nextOpen;
+		if (getInfo()->m_nextOpen)
+			getInfo()->m_nextOpen->m_prevOpen = this->getInfo();
+		lastCell->getInfo()->m_nextOpen = this->getInfo();
+	}
 
-			m_info->m_prevOpen = c->m_info->m_prevOpen;
-			c->m_info->m_prevOpen = this->m_info;
+#ifdef RTS_DEBUG
+	DEBUG_ASSERTCRASH(getInfo()->m_prevOpen == NULL || getInfo()->m_prevOpen->m_openCost <= getInfo()->m_totalCost, ("Open list is not sorted."));
+	DEBUG_ASSERTCRASH(getInfo()->m_nextOpen == NULL || getInfo()->m_nextOpen->m_openCost > getInfo()->m_totalCost, ("Open list is not sorted."));
+#endif
 
-			m_info->m_nextOpen = c->m_info;
-
-		}
-		else
-		{
-			// append after "lastCell" - end of list
-			lastCell->m_info->m_nextOpen = this->m_info;
-			m_info->m_prevOpen = lastCell->m_info;
-			m_info->m_nextOpen = NULL;
-		}
-	}
+	getInfo()->m_openCost = getInfo()->m_totalCost;
+	s_openListIndex.addCell(this, getInfo()->m_openCost);
 
 	// mark newCell as being on open list
-	m_info->m_open = true;
-	m_info->m_closed = false;
+	getInfo()->m_open = true;
+	getInfo()->m_closed = false;
 
 	return list;
 }
@@ -1559,19 +1677,25 @@ PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
 /// remove self from "open" list
 PathfindCell *PathfindCell::removeFromOpenList( PathfindCell *list )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
-	if (m_info->m_nextOpen)
-		m_info->m_nextOpen->m_prevOpen = m_info->m_prevOpen;
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	DEBUG_ASSERTCRASH(getInfo()->m_closed==FALSE && getInfo()->m_open==TRUE, ("Serious error - Invalid flags. jba"));
+
+	// Note that m_totalCost may already have changed, so use the cost we were inserted with.
+	PathfindCellInfo *prevInfo = getInfo()->m_prevOpen;
+	PathfindCell *prevCellWithSameCost = (prevInfo && prevInfo->m_openCost == getInfo()->m_openCost) ? prevInfo->m_cell : NULL;
+	s_openListIndex.removeCell(this, getInfo()->m_openCost, prevCellWithSameCost);
+
+	if (getInfo()->m_nextOpen)
+		getInfo()->m_nextOpen->m_prevOpen = getInfo()->m_prevOpen;
 
-	if (m_info->m_prevOpen)
-		m_info->m_prevOpen->m_nextOpen = m_info->m_nextOpen;
+	if (getInfo()->m_prevOpen)
+		getInfo()->m_prevOpen->m_nextOpen = getInfo()->m_nextOpen;
 	else
 		list = getNextOpen();
 
-	m_info->m_open = false;
-	m_info->m_nextOpen = NULL;
-	m_info->m_prevOpen = NULL;
+	getInfo()->m_open = false;
+	getInfo()->m_nextOpen = NULL;
+	getInfo()->m_prevOpen = NULL;
 
 	return list;
 }
@@ -1582,34 +1706,43 @@ Int PathfindCell::releaseOpenList( PathfindCell *list )
 	Int count = 0;
 	while (list) {
 		count++;
-		DEBUG_ASSERTCRASH(list->m_info, ("Has to have info."));
-		DEBUG_ASSERTCRASH(list->m_info->m_closed==FALSE && list->m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
+		DEBUG_ASSERTCRASH(list->getInfo(), ("Has to have info."));
+		DEBUG_ASSERTCRASH(list->getInfo()->m_closed==FALSE && list->getInfo()->m_open==TRUE, ("Serious error - Invalid flags. jba"));
 		PathfindCell *cur = list;
-		PathfindCellInfo *curInfo = list->m_info;
+		PathfindCellInfo *curInfo = list->getInfo();
 		if (curInfo->m_nextOpen) {
 			list = curInfo->m_nextOpen->m_cell;
 		}	else {
 			list = NULL;
 		}
 		DEBUG_ASSERTCRASH(cur == curInfo->m_cell, ("Bad backpointer in PathfindCellInfo"));
+		// The list is released front to back, so no cell in front of this one is left.
+		s_openListIndex.removeCell(cur, curInfo->m_openCost, NULL);
 		curInfo->m_nextOpen = NULL;
 		curInfo->m_prevOpen = NULL;
 		curInfo->m_open = FALSE;
 		cur->releaseInfo();
 	}
+	DEBUG_ASSERTCRASH(s_openListIndex.isEmpty(), ("Open list index is out of sync."));
 	return count;
 }
 
+/// forget all cells of the open list index
+void PathfindCell::resetOpenListIndex( void )
+{
+	s_openListIndex.reset();
+}
+
 /// remove all cells from "closed" list
 Int PathfindCell::releaseClosedList( PathfindCell *list )
 {
 	Int count = 0;
 	while (list) {
 		count++;
-		DEBUG_ASSERTCRASH(list->m_info, ("Has to have info."));
-		DEBUG_ASSERTCRASH(list->m_info->m_closed==TRUE && list->m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
+		DEBUG_ASSERTCRASH(list->getInfo(), ("Has to have info."));
+		DEBUG_ASSERTCRASH(list->getInfo()->m_closed==TRUE && list->getInfo()->m_open==FALSE, ("Serious error - Invalid flags. jba"));
 		PathfindCell *cur = list;
-		PathfindCellInfo *curInfo = list->m_info;
+		PathfindCellInfo *curInfo = list->getInfo();
 		if (curInfo->m_nextOpen) {
 			list = curInfo->m_nextOpen->m_cell;
 		}	else {
@@ -1627,18 +1760,18 @@ Int PathfindCell::releaseClosedList( PathfindCell *list )
 /// put self on "closed" list, return new list
 PathfindCell *PathfindCell::putOnClosedList( PathfindCell *list )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	DEBUG_ASSERTCRASH(getInfo()->m_closed==FALSE && getInfo()->m_open==FALSE, ("Serious error - Invalid flags. jba"));
 	// only put on list if not already on it
-	if (m_info->m_closed == FALSE)
+	if (getInfo()->m_closed == FALSE)
 	{
-		m_info->m_closed = FALSE;
-		m_info->m_closed = TRUE;
+		getInfo()->m_closed = FALSE;
+		getInfo()->m_closed = TRUE;
 
-		m_info->m_prevOpen = NULL;
-		m_info->m_nextOpen = list?list->m_info:NULL;
+		getInfo()->m_prevOpen = NULL;
+		getInfo()->m_nextOpen = list?list->getInfo():NULL;
 		if (list)
-			list->m_info->m_prevOpen = this->m_info;
+			list->getInfo()->m_prevOpen = this->getInfo();
 
 		list = this;
 	}
@@ -1649,19 +1782,19 @@ PathfindCell *PathfindCell::putOnClosedList( PathfindCell *list )
 /// remove self from "closed" list
 PathfindCell *PathfindCell::removeFromClosedList( PathfindCell *list )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	DEBUG_ASSERTCRASH(m_info->m_closed==TRUE && m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
-	if (m_info->m_nextOpen)
-		m_info->m_nextOpen->m_prevOpen = m_info->m_prevOpen;
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	DEBUG_ASSERTCRASH(getInfo()->m_closed==TRUE && getInfo()->m_open==FALSE, ("Serious error - Invalid flags. jba"));
+	if (getInfo()->m_nextOpen)
+		getInfo()->m_nextOpen->m_prevOpen = getInfo()->m_prevOpen;
 
-	if (m_info->m_prevOpen)
-		m_info->m_prevOpen->m_nextOpen = m_info->m_nextOpen;
+	if (getInfo()->m_prevOpen)
+		getInfo()->m_prevOpen->m_nextOpen = getInfo()->m_nextOpen;
 	else
 		list = getNextOpen();
 
-	m_info->m_closed = false;
-	m_info->m_nextOpen = NULL;
-	m_info->m_prevOpen = NULL;
+	getInfo()->m_closed = false;
+	getInfo()->m_nextOpen = NULL;
+	getInfo()->m_prevOpen = NULL;
 
 	return list;
 }
@@ -1673,9 +1806,9 @@ const Real COST_TO_DISTANCE_FACTOR_SQR = COST_TO_DISTANCE_FACTOR*COST_TO_DISTANC
 
 UnsignedInt PathfindCell::costToGoal( PathfindCell *goal )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
-	Int dx = m_info->m_pos.x - goal->getXIndex();
-	Int dy = m_info->m_pos.y - goal->getYIndex();
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
+	Int dx = getInfo()->m_pos.x - goal->getXIndex();
+	Int dy = getInfo()->m_pos.y - goal->getYIndex();
 #define NO_REAL_DIST
 #ifdef REAL_DIST
 	Int cost = COST_ORTHOGONAL*sqrt(dx*dx + dy*dy);
@@ -1697,20 +1830,20 @@ UnsignedInt PathfindCell::costToGoal( PathfindCell *goal )
 
 UnsignedInt PathfindCell::costToHierGoal( PathfindCell *goal )
 {
-	if( !m_info )
+	if( !hasInfo() )
 	{
 		DEBUG_CRASH( ("Has to have info.") );
 		return 100000; //...patch hack 1.01
 	}
-	Int dx = m_info->m_pos.x - goal->getXIndex();
-	Int dy = m_info->m_pos.y - goal->getYIndex();
+	Int dx = getInfo()->m_pos.x - goal->getXIndex();
+	Int dy = getInfo()->m_pos.y - goal->getYIndex();
 	Int cost = REAL_TO_INT_FLOOR(COST_ORTHOGONAL*sqrt(dx*dx + dy*dy) + 0.5f);
 	return cost;
 }
 
 UnsignedInt PathfindCell::costSoFar( PathfindCell *parent )
 {
-	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
+	DEBUG_ASSERTCRASH(hasInfo(), ("Has to have info."));
 	// very first node in path - no turns, no cost
 	if (parent == NULL)
 		return 0;
@@ -1719,8 +1852,8 @@ UnsignedInt PathfindCell::costSoFar( PathfindCell *parent )
 	ICoord2D prevDir;
 	Int cost;
 
-	prevDir.x = parent->getXIndex() - m_info->m_pos.x;
-	prevDir.y = parent->getYIndex() - m_info->m_pos.y;
+	prevDir.x = parent->getXIndex() - getInfo()->m_pos.x;
+	prevDir.y = parent->getYIndex() - getInfo()->m_pos.y;
 
 	// diagonal moves cost a bit more than orthogonal ones
 	if (prevDir.x == 0 || prevDir.y == 0)
@@ -1943,6 +2076,77 @@ inline void applyBlockZone(PathfindCell &targetCell, const PathfindCell &sourceC
 
 }
 
+static Int findZoneRoot(zoneStorageType *zoneEquivalency, Int zone)
+{
+	while (zoneEquivalency[zone] != zone) {
+		zoneEquivalency[zone] = zoneEquivalency[zoneEquivalency[zone]];
+		zone = zoneEquivalency[zone];
+	}
+	return zone;
+}
+
+static void joinZones(zoneStorageType *zoneEquivalency, Int zone1, Int zone2)
+{
+	// Keep the lower zone, like resolveZones.
+	zone1 = findZoneRoot(zoneEquivalency, zone1);
+	zone2 = findZoneRoot(zoneEquivalency, zone2);
+	if (zone1 < zone2) {
+		zoneEquivalency[zone2] = zone1;
+	} else if (zone2 < zone1) {
+		zoneEquivalency[zone1] = zone2;
+	}
+}
+
+/* Which zone equivalency tables calculateZones joins for these neighboring cells. */
+static UnsignedByte getZoneLinkTables(const PathfindCell &cell, const PathfindCell &neighbor, Bool leftNeighbor)
+{
+	if (cell.getType() == neighbor.getType()) {
+		return ZoneLink::HIERARCHICAL;
+	}
+	UnsignedByte tables = 0;
+	if (terrain(cell, neighbor)) {
+		tables |= ZoneLink::TERRAIN;
+	}
+	if (crusherGround(cell, neighbor)) {
+		tables |= ZoneLink::CRUSHER;
+	}
+	// calculateZones skips these for the left neighbor if it was a terrain or crusher match.
+	if (tables == 0 || !leftNeighbor) {
+		if (waterGround(cell, neighbor)) {
+			tables |= ZoneLink::GROUND_WATER;
+		} else if (groundRubble(cell, neighbor)) {
+			tables |= ZoneLink::GROUND_RUBBLE;
+		} else if (groundCliff(cell, neighbor)) {
+			tables |= ZoneLink::GROUND_CLIFF;
+		}
+	}
+	return tables;
+}
+
+static void addZoneLink(std::vector<ZoneLink> &links, zoneStorageType zone1, zoneStorageType zone2, UnsignedByte tables)
+{
+	if (tables == 0) {
+		return;
+	}
+	if (zone2 < zone1) {
+		zoneStorageType tmp = zone1;
+		zone1 = zone2;
+		zone2 = tmp;
+	}
+	size_t i;
+	for (i=0; i<links.size(); i++) {
+		if (links[i].zone1 == zone1 && links[i].zone2 == zone2) {
+			links[i].tables |= tables;
+			return;
+		}
+	}
+	ZoneLink link;
+	link.zone1 = zone1;
+	link.zone2 = zone2;
+	link.tables = tables;
+	links.push_back(link);
+}
+
 //------------------------  ZoneBlock  -------------------------------
 ZoneBlock::ZoneBlock() : m_firstZone(0),
 m_numZones(0),
@@ -1951,7 +2155,8 @@ m_groundWaterZones(NULL),
 m_groundRubbleZones(NULL),
 m_crusherZones(NULL),
 m_zonesAllocated(0),
-m_interactsWithBridge(FALSE)
+m_interactsWithBridge(FALSE),
+m_dirty(FALSE)
 {
 	m_cellOrigin.x = 0;
 	m_cellOrigin.y = 0;
@@ -2159,7 +2364,12 @@ m_crusherZones(NULL),
 m_hierarchicalZones(NULL),
 m_blockOfZoneBlocks(NULL),
 m_zoneBlocks(NULL),
-m_zonesAllocated(0)
+m_zonesAllocated(0),
+m_zoneLinksValid(FALSE),
+m_numCachedRoutes(0),
+m_nextCachedRoute(0),
+m_routeCacheFrame(0),
+m_isRouteCacheBypassed(FALSE)
 {
 	m_zoneBlockExtent.x = 0;
 	m_zoneBlockExtent.y = 0;
@@ -2202,6 +2412,8 @@ void PathfindZoneManager::freeZones()
 
 void PathfindZoneManager::freeBlocks()
 {
+	m_dirtyBlocks.clear();
+	m_zoneLinksValid = FALSE;
 	if (m_blockOfZoneBlocks) {
 		delete [] m_blockOfZoneBlocks;
 		m_blockOfZoneBlocks = NULL;
@@ -2259,11 +2471,14 @@ void PathfindZoneManager::reset(void)  ///< Called when the map is reset.
 {
 	freeZones();
 	freeBlocks();
+	clearRouteCache();
 }
 
 
 void PathfindZoneManager::markZonesDirty( Bool insert )  ///< Called when the zones need to be recalculated.
 {
+	// Something was built, removed or repaired, so the cached routes may lead through it.
+	clearRouteCache();
 
 	if (TheGameLogic->getFrame()<2) {
 		m_nextFrameToCalculateZones = 2;
@@ -2293,6 +2508,7 @@ static  Bool  s_stopForceCalling = FALSE;
 
 void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds )
 {
+	clearRouteCache();
 
 #ifdef DEBUG_QPF
 #if defined(DEBUG_LOGGING)
@@ -2308,7 +2524,7 @@ void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer laye
 
 
 	m_maxZone = 1;	// we start using zone 0 as a flag.
-	const Int maxZones=24000;
+	const Int maxZones=MAX_ZONES;
 	zoneStorageType zoneEquivalency[maxZones];
 	Int i, j;
 	for (i=0; i<maxZones; i++) {
@@ -2821,6 +3037,19 @@ void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer laye
 		}
 	}
 #endif
+
+#if !RETAIL_COMPATIBLE_CRC
+	// Remember how the zones of each block link up, so that updateDirtyBlocks can redo single blocks.
+	for (xBlock=0; xBlock<xCount; xBlock++) {
+		for (yBlock=0; yBlock<yCount; yBlock++) {
+			m_zoneBlocks[xBlock][yBlock].setDirty(false);
+			calculateBlockLinks(map, layers, globalBounds, xBlock, yBlock);
+		}
+	}
+	m_dirtyBlocks.clear();
+	m_zoneLinksValid = true;
+#endif
+
 	m_nextFrameToCalculateZones = 0xffffffff;
 }
 
@@ -2832,6 +3061,7 @@ void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer laye
  */
 void PathfindZoneManager::updateZonesForModify(PathfindCell **map, PathfindLayer layers[], const IRegion2D &structureBounds, const IRegion2D &globalBounds )
 {
+	clearRouteCache();
 
 #ifdef DEBUG_QPF
 #if defined(DEBUG_LOGGING)
@@ -2875,6 +3105,9 @@ void PathfindZoneManager::updateZonesForModify(PathfindCell **map, PathfindLayer
 			if (blockBounds.lo.x>blockBounds.hi.x || blockBounds.lo.y>blockBounds.hi.y) {
 				continue;
 			}
+#if !RETAIL_COMPATIBLE_CRC
+			markBlockDirty(xBlock, yBlock);
+#endif
 			m_zoneBlocks[xBlock][yBlock].setInteractsWithBridge(false);
 			Int i, j;
 			for( j=blockBounds.lo.y; j<=blockBounds.hi.y; j++ )	{
@@ -2978,6 +3211,273 @@ void PathfindZoneManager::updateZonesForModify(PathfindCell **map, PathfindLayer
 
 
 
+/**
+ * Get the cell bounds of a zone block, the same way calculateZones does.
+ */
+void PathfindZoneManager::getBlockBounds(const IRegion2D &globalBounds, Int xBlock, Int yBlock, IRegion2D &bounds) const
+{
+	bounds.lo.x = globalBounds.lo.x + xBlock*ZONE_BLOCK_SIZE;
+	bounds.lo.y = globalBounds.lo.y + yBlock*ZONE_BLOCK_SIZE;
+	bounds.hi.x = bounds.lo.x + ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
+	bounds.hi.y = bounds.lo.y + ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
+	if (bounds.hi.x > globalBounds.hi.x) {
+		bounds.hi.x = globalBounds.hi.x;
+	}
+	if (bounds.hi.y > globalBounds.hi.y) {
+		bounds.hi.y = globalBounds.hi.y;
+	}
+}
+
+/**
+ * Remember that the cells of this block changed, so updateDirtyBlocks redoes it.
+ */
+void PathfindZoneManager::markBlockDirty(Int xBlock, Int yBlock)
+{
+	ZoneBlock &block = m_zoneBlocks[xBlock][yBlock];
+	if (block.isDirty()) {
+		return;
+	}
+	block.setDirty(true);
+	ICoord2D ndx;
+	ndx.x = xBlock;
+	ndx.y = yBlock;
+	m_dirtyBlocks.push_back(ndx);
+}
+
+/**
+ * Zone the cells of one block like the first pass of calculateZones.  The block gets new zone
+ * numbers after the ones in use, so the zones of all other blocks stay as they are.
+ */
+void PathfindZoneManager::calculateBlockCellZones(PathfindCell **map, ZoneBlock &block, const IRegion2D &bounds)
+{
+	zoneStorageType zoneEquivalency[ZONE_BLOCK_SIZE*ZONE_BLOCK_SIZE+1];
+	zoneStorageType collapsedZones[ZONE_BLOCK_SIZE*ZONE_BLOCK_SIZE+1];
+	Int numZones = 1;	// we start using zone 0 as a flag.
+	zoneEquivalency[0] = 0;
+
+	block.setInteractsWithBridge(false);
+	Int i, j;
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			PathfindCell *cell = &map[i][j];
+			Int zone = 0;
+			if (i>bounds.lo.x && cell->getType() == map[i-1][j].getType()) {
+				zone = findZoneRoot(zoneEquivalency, map[i-1][j].getZone());
+			}
+			if (j>bounds.lo.y && cell->getType() == map[i][j-1].getType()) {
+				Int topZone = findZoneRoot(zoneEquivalency, map[i][j-1].getZone());
+				if (zone == 0) {
+					zone = topZone;
+				} else {
+					joinZones(zoneEquivalency, zone, topZone);
+				}
+			}
+			if (zone == 0) {
+				zone = numZones;
+				zoneEquivalency[numZones] = numZones;
+				numZones++;
+			}
+			cell->setZone(zone);
+			if (cell->getConnectLayer() > LAYER_GROUND) {
+				block.setInteractsWithBridge(true);
+			}
+		}
+	}
+
+	// Collapse the zones into a sequence after m_maxZone.  A joined zone always has a lower root.
+	Int firstZone = m_maxZone;
+	for (i=1; i<numZones; i++) {
+		Int zone = findZoneRoot(zoneEquivalency, i);
+		if (zone == i) {
+			collapsedZones[i] = m_maxZone;
+			m_maxZone++;
+		} else {
+			collapsedZones[i] = collapsedZones[zone];
+		}
+	}
+	DEBUG_ASSERTCRASH(m_maxZone > firstZone, ("Block without zones."));
+	DEBUG_ASSERTCRASH(m_maxZone <= PathfindCell::MAX_CELL_ZONES, ("Zone %d doesn't fit in the cell.", m_maxZone-1));
+
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			PathfindCell *cell = &map[i][j];
+			cell->setZone(collapsedZones[cell->getZone()]);
+		}
+	}
+}
+
+/**
+ * Collect the zones that the cells of a block join with each other, with the cells left and
+ * above the block, and with bridges.  These are the joins of the second pass of calculateZones.
+ */
+void PathfindZoneManager::calculateBlockLinks(PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds, Int xBlock, Int yBlock)
+{
+	IRegion2D bounds;
+	getBlockBounds(globalBounds, xBlock, yBlock, bounds);
+	std::vector<ZoneLink> &links = m_zoneBlocks[xBlock][yBlock].getZoneLinks();
+	links.clear();
+
+	Int i, j;
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			const PathfindCell &cell = map[i][j];
+			if ( (cell.getConnectLayer() > LAYER_GROUND) &&
+				(cell.getType() == PathfindCell::CELL_CLEAR) ) {
+				const PathfindLayer *layer = layers + cell.getConnectLayer();
+				addZoneLink(links, cell.getZone(), layer->getZone(), ZoneLink::HIERARCHICAL);
+			}
+			if (i>globalBounds.lo.x && cell.getZone()!=map[i-1][j].getZone()) {
+				addZoneLink(links, cell.getZone(), map[i-1][j].getZone(), getZoneLinkTables(cell, map[i-1][j], true));
+			}
+			if (j>globalBounds.lo.y && cell.getZone()!=map[i][j-1].getZone()) {
+				addZoneLink(links, cell.getZone(), map[i][j-1].getZone(), getZoneLinkTables(cell, map[i][j-1], false));
+			}
+		}
+	}
+}
+
+/**
+ * Rebuild the zone equivalency tables from the links of all blocks.  Any zone linked for
+ * a table is also linked by the hierarchical links, which is what flattenZones does.
+ */
+void PathfindZoneManager::resolveZoneLinks(void)
+{
+	Int i;
+	for (i=0; i<m_zonesAllocated; i++) {
+		m_hierarchicalZones[i] = i;
+	}
+
+	Int xBlock, yBlock;
+	size_t k;
+	for (xBlock=0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock=0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			const std::vector<ZoneLink> &links = m_zoneBlocks[xBlock][yBlock].getZoneLinks();
+			for (k=0; k<links.size(); k++) {
+				if (links[k].tables & ZoneLink::HIERARCHICAL) {
+					joinZones(m_hierarchicalZones, links[k].zone1, links[k].zone2);
+				}
+			}
+		}
+	}
+
+	for (i=0; i<m_zonesAllocated; i++) {
+		m_hierarchicalZones[i] = findZoneRoot(m_hierarchicalZones, i);
+		m_groundCliffZones[i] = m_groundWaterZones[i] = m_groundRubbleZones[i] = m_terrainZones[i] = m_crusherZones[i] = m_hierarchicalZones[i];
+	}
+
+	for (xBlock=0; xBlock<m_zoneBlockExtent.x; xBlock++) {
+		for (yBlock=0; yBlock<m_zoneBlockExtent.y; yBlock++) {
+			const std::vector<ZoneLink> &links = m_zoneBlocks[xBlock][yBlock].getZoneLinks();
+			for (k=0; k<links.size(); k++) {
+				const ZoneLink &link = links[k];
+				if (link.tables & ZoneLink::TERRAIN) {
+					joinZones(m_terrainZones, link.zone1, link.zone2);
+				}
+				if (link.tables & ZoneLink::CRUSHER) {
+					joinZones(m_crusherZones, link.zone1, link.zone2);
+				}
+				if (link.tables & ZoneLink::GROUND_WATER) {
+					joinZones(m_groundWaterZones, link.zone1, link.zone2);
+				}
+				if (link.tables & ZoneLink::GROUND_RUBBLE) {
+					joinZones(m_groundRubbleZones, link.zone1, link.zone2);
+				}
+				if (link.tables & ZoneLink::GROUND_CLIFF) {
+					joinZones(m_groundCliffZones, link.zone1, link.zone2);
+				}
+			}
+		}
+	}
+
+	for (i=0; i<m_zonesAllocated; i++) {
+		m_groundCliffZones[i] = findZoneRoot(m_groundCliffZones, i);
+		m_groundWaterZones[i] = findZoneRoot(m_groundWaterZones, i);
+		m_groundRubbleZones[i] = findZoneRoot(m_groundRubbleZones, i);
+		m_terrainZones[i] = findZoneRoot(m_terrainZones, i);
+		m_crusherZones[i] = findZoneRoot(m_crusherZones, i);
+	}
+}
+
+/**
+ * Recalculate the zones of the blocks changed by updateZonesForModify, instead of the whole map.
+ * Only the links of the changed blocks and their right and lower neighbors are collected again,
+ * the equivalency tables are then rebuilt from the links of all blocks.
+ */
+void PathfindZoneManager::updateDirtyBlocks( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds )
+{
+	// Zone numbers of redone blocks aren't reused, so start over before they no longer fit in a cell.
+	// MAX_ZONES is only the scratch limit of calculateZones, the cells store compacted zones.
+	const Int maxNewZones = (Int)m_dirtyBlocks.size()*ZONE_BLOCK_SIZE*ZONE_BLOCK_SIZE;
+	if (!m_zoneLinksValid || m_maxZone + maxNewZones >= PathfindCell::MAX_CELL_ZONES) {
+		calculateZones(map, layers, globalBounds);
+		return;
+	}
+
+#ifdef DEBUG_QPF
+#if defined(DEBUG_LOGGING)
+	__int64 startTime64;
+	double timeToUpdate=0.0f;
+	__int64 endTime64,freq64;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+	QueryPerformanceCounter((LARGE_INTEGER *)&startTime64);
+#endif
+#endif
+
+	clearRouteCache();
+
+	size_t k;
+	for (k=0; k<m_dirtyBlocks.size(); k++) {
+		IRegion2D bounds;
+		getBlockBounds(globalBounds, m_dirtyBlocks[k].x, m_dirtyBlocks[k].y, bounds);
+		calculateBlockCellZones(map, m_zoneBlocks[m_dirtyBlocks[k].x][m_dirtyBlocks[k].y], bounds);
+	}
+
+	Int i;
+	for (i=0; i<=LAYER_LAST; i++) {
+		if (!layers[i].isUnused() && !layers[i].isDestroyed()) {
+			ICoord2D ndx;
+			layers[i].getStartCellIndex(&ndx);
+			setBridge(ndx.x, ndx.y, true);
+			layers[i].getEndCellIndex(&ndx);
+			setBridge(ndx.x, ndx.y, true);
+		}
+	}
+
+	allocateZones();
+
+	for (k=0; k<m_dirtyBlocks.size(); k++) {
+		const ICoord2D &ndx = m_dirtyBlocks[k];
+		IRegion2D bounds;
+		getBlockBounds(globalBounds, ndx.x, ndx.y, bounds);
+		m_zoneBlocks[ndx.x][ndx.y].blockCalculateZones(map, layers, bounds);
+
+		// The blocks right and below link to the cells of this block.
+		calculateBlockLinks(map, layers, globalBounds, ndx.x, ndx.y);
+		if (ndx.x+1 < m_zoneBlockExtent.x && !m_zoneBlocks[ndx.x+1][ndx.y].isDirty()) {
+			calculateBlockLinks(map, layers, globalBounds, ndx.x+1, ndx.y);
+		}
+		if (ndx.y+1 < m_zoneBlockExtent.y && !m_zoneBlocks[ndx.x][ndx.y+1].isDirty()) {
+			calculateBlockLinks(map, layers, globalBounds, ndx.x, ndx.y+1);
+		}
+	}
+
+	for (k=0; k<m_dirtyBlocks.size(); k++) {
+		m_zoneBlocks[m_dirtyBlocks[k].x][m_dirtyBlocks[k].y].setDirty(false);
+	}
+
+	resolveZoneLinks();
+
+#ifdef DEBUG_QPF
+#if defined(DEBUG_LOGGING)
+	QueryPerformanceCounter((LARGE_INTEGER *)&endTime64);
+	timeToUpdate = ((double)(endTime64-startTime64) / (double)(freq64));
+	DEBUG_LOG(("Time to update %d zone blocks %f", (Int)m_dirtyBlocks.size(), timeToUpdate));
+#endif
+#endif
+
+	m_dirtyBlocks.clear();
+}
+
 //
 // Clear the passable flags.
 //
@@ -3004,6 +3504,96 @@ void PathfindZoneManager::setAllPassable( )
 	}
 }
 
+//
+// Compare route keys.
+//
+Bool PathfindZoneManager::RouteKey::operator==(const RouteKey &other) const
+{
+	return startBlock.x == other.startBlock.x && startBlock.y == other.startBlock.y &&
+		goalBlock.x == other.goalBlock.x && goalBlock.y == other.goalBlock.y &&
+		startZone == other.startZone && goalZone == other.goalZone &&
+		startLayer == other.startLayer && goalLayer == other.goalLayer &&
+		surfaces == other.surfaces && isHuman == other.isHuman &&
+		crusher == other.crusher && closestOK == other.closestOK;
+}
+
+//
+// Clear the cached hierarchical routes.
+//
+void PathfindZoneManager::clearRouteCache( )
+{
+	m_numCachedRoutes = 0;
+	m_nextCachedRoute = 0;
+}
+
+//
+// Routes are only kept for the frame they were found in, as units and obstacles keep moving.
+//
+void PathfindZoneManager::updateRouteCacheFrame( )
+{
+	if (m_routeCacheFrame != TheGameLogic->getFrame()) {
+		clearRouteCache();
+		m_routeCacheFrame = TheGameLogic->getFrame();
+	}
+}
+
+//
+// Set the passable flags of a cached route.
+//
+Bool PathfindZoneManager::applyCachedRoute(const RouteKey &key, Bool &found)
+{
+	if (m_isRouteCacheBypassed) {
+		return false;
+	}
+	updateRouteCacheFrame();
+	Int i;
+	for (i=0; i<m_numCachedRoutes; i++) {
+		const CachedRoute &route = m_cachedRoutes[i];
+		if (!(route.key == key)) {
+			continue;
+		}
+		found = route.found;
+		size_t j;
+		for (j=0; j<route.blocks.size(); j++) {
+			m_zoneBlocks[route.blocks[j].x][route.blocks[j].y].setPassable(true);
+		}
+		return true;
+	}
+	return false;
+}
+
+//
+// Cache the currently passable blocks as a route.
+//
+void PathfindZoneManager::cacheRoute(const RouteKey &key, Bool found)
+{
+	if (m_isRouteCacheBypassed) {
+		return;
+	}
+	updateRouteCacheFrame();
+	CachedRoute *route;
+	if (m_numCachedRoutes < MAX_CACHED_ROUTES) {
+		route = &m_cachedRoutes[m_numCachedRoutes++];
+	}	else {
+		route = &m_cachedRoutes[m_nextCachedRoute];
+		m_nextCachedRoute = (m_nextCachedRoute+1) % MAX_CACHED_ROUTES;
+	}
+	route->key = key;
+	route->found = found;
+	route->blocks.clear();
+	if (!found) {
+		return;
+	}
+	ICoord2D block;
+	for (block.x = 0; block.x<m_zoneBlockExtent.x; block.x++) {
+		for (block.y = 0; block.y<m_zoneBlockExtent.y; block.y++) {
+			if (m_zoneBlocks[block.x][block.y].isPassable()) {
+				route->blocks.push_back(block);
+			}
+		}
+	}
+}
+
 //
 // Set the passable flag for the block at this location.
 //
@@ -3821,21 +4411,34 @@ void PathfindLayer::classifyWallMapCell( Int i, Int j , PathfindCell *cell, Obje
 
 //----------------------- Pathfinder ---------------------------------------
 
-Pathfinder::Pathfinder( void ) :m_map(NULL)
+Pathfinder::Pathfinder( void ) :m_map(NULL), m_isProcessingQueue(false), m_benchmark(NULL)
 {
 	debugPath = NULL;
 	PathfindCellInfo::allocateCellInfos();
 	reset();
+
+	if (TheGlobalData->m_pathfindCaptureFile.isNotEmpty() || TheGlobalData->m_pathfindBenchmarkFile.isNotEmpty())
+	{
+		m_benchmark = NEW PathfindBenchmark;
+		m_benchmark->init(TheGlobalData->m_pathfindCaptureFile, TheGlobalData->m_pathfindBenchmarkFile);
+	}
 }
 
 Pathfinder::~Pathfinder( void )
 {
+	delete m_benchmark;
+	m_benchmark = NULL;
 	PathfindCellInfo::releaseCellInfos();
 }
 
 void Pathfinder::reset( void )
 {
 	frameToShowObstacles = 0;
+
+	// Results are reported per game.
+	if (m_benchmark) {
+		m_benchmark->report();
+	}
 	DEBUG_LOG(("Pathfind cell is %d bytes, PathfindCellInfo is %d bytes", sizeof(PathfindCell), sizeof(PathfindCellInfo)));
 
 	if (m_blockOfMapCells) {
@@ -3856,6 +4459,7 @@ void Pathfinder::reset( void )
 	m_extent.lo.x=m_extent.lo.y=m_extent.hi.x=m_extent.hi.y=0;
 	m_logicalExtent.lo.x=m_logicalExtent.lo.y=m_logicalExtent.hi.x=m_logicalExtent.hi.y=0;
 	m_openList = NULL;
+	PathfindCell::resetOpenListIndex();
 	m_closedList = NULL;
 
 	m_ignoreObstacleID = INVALID_ID;
@@ -4068,7 +4672,9 @@ void Pathfinder::classifyFence( Object *obj, Bool insert )
  		}
  	}
 	if (didAnything) {
+#if RETAIL_COMPATIBLE_CRC
 		m_zoneManager.markZonesDirty( insert );
+#endif
 		m_zoneManager.updateZonesForModify(m_map, m_layers, cellBounds, m_extent);
 	}
 #if 0
@@ -4210,7 +4816,9 @@ void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 	{
 		case GEOMETRY_BOX:
 		{
+#if RETAIL_COMPATIBLE_CRC
 			m_zoneManager.markZonesDirty( insert );
+#endif
 
 			Real angle = obj->getOrientation();
 
@@ -4269,7 +4877,9 @@ void Pathfinder::internal_classifyObjectFootprint( Object *obj, Bool insert )
 		case GEOMETRY_SPHERE:	// not quite right, but close enough
 		case GEOMETRY_CYLINDER:
 		{
+#if RETAIL_COMPATIBLE_CRC
 			m_zoneManager.markZonesDirty( insert );
+#endif
 			// fill in all cells that overlap as obstacle cells
 			/// @todo This is a very inefficient circle-rasterizer
 			ICoord2D topLeft, bottomRight;
@@ -5910,6 +6520,13 @@ void Pathfinder::processPathfindQueue(void)
 		return;
 	}
 
+#if !RETAIL_COMPATIBLE_CRC
+	// Redo only the zone blocks that structures were added to or removed from, and keep on pathfinding.
+	if (m_zoneManager.hasDirtyBlocks()) {
+		m_zoneManager.updateDirtyBlocks(m_map, m_layers, m_extent);
+	}
+#endif
+
 	// Get the current logical extent.
 	Region3D terrainExtent;
 	TheTerrainLogic->getExtent( &terrainExtent );
@@ -5933,7 +6550,10 @@ void Pathfinder::processPathfindQueue(void)
 		if (obj) {
 			AIUpdateInterface *ai = obj->getAIUpdateInterface();
 			if (ai) {
+				// Only the requests served here are captured, not the direct path queries.
+				m_isProcessingQueue = true;
 				ai->doPathfind(this);
+				m_isProcessingQueue = false;
 #ifdef DEBUG_QPF
 				pathsFound++;
 #endif
@@ -5957,6 +6577,11 @@ void Pathfinder::processPathfindQueue(void)
 #endif
 #endif
 	}
+
+	if (m_benchmark && m_benchmark->isBenchmarking()) {
+		m_benchmark->runRequests(this, TheGameLogic->getFrame());
+	}
+
 #if defined(RTS_DEBUG)
 	doDebugIcons();
 #endif
@@ -6389,6 +7014,9 @@ Int Pathfinder::examineNeighboringCells(PathfindCell *parentCell, PathfindCell *
 Path *Pathfinder::findPath( Object *obj, const LocomotorSet& locomotorSet, const Coord3D *from,
 													 const Coord3D *rawTo)
 {
+	if (m_benchmark && m_isProcessingQueue && m_benchmark->isCapturing()) {
+		m_benchmark->captureRequest(PathfindBenchmark::REQUEST_FIND_PATH, obj, locomotorSet, from, rawTo, false, 0.0f, false);
+	}
 	if (!clientSafeQuickDoesPathExist(locomotorSet, from, rawTo)) {
 		return NULL;
 	}
@@ -6397,13 +7025,7 @@ Path *Pathfinder::findPath( Object *obj, const LocomotorSet& locomotorSet, const
 		isHuman = false; // computer gets to cheat.
 	}
 
-	m_zoneManager.clearPassableFlags();
-	Path *hPat = findHierarchicalPath(isHuman, locomotorSet, from, rawTo, false);
-	if (hPat) {
-		deleteInstance(hPat);
-	}	else {
-		m_zoneManager.setAllPassable();
-	}
+	restrictToHierarchicalPath(isHuman, locomotorSet.getValidSurfaces(), from, rawTo, false, FALSE);
 
 	Path *pat = internalFindPath(obj, locomotorSet, from, rawTo);
 	if (pat!=NULL) {
@@ -6850,25 +7472,6 @@ Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *go
 
 	prependCells(path, fromPos, goalCell, true);
 
-	// Expand the hierarchical path around the starting point. jba [8/24/2003]
-	// This allows the unit to get around friendly units that may be near it.
-	Coord3D pos = *path->getFirstNode()->getPosition();
-	Coord3D minPos = pos;
-	minPos.x -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	minPos.y -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	Coord3D maxPos = pos;
-	maxPos.x += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	maxPos.y += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
-	ICoord2D cellNdxMin, cellNdxMax;
-	worldToCell(&minPos, &cellNdxMin);
-	worldToCell(&maxPos, &cellNdxMax);
-	Int i, j;
-	for (i=cellNdxMin.x; i<=cellNdxMax.x; i++) {
-		for (j=cellNdxMin.y; j<=cellNdxMax.y; j++) {
-			m_zoneManager.setPassable(i, j, true);
-		}
-	}
-
 #if defined(RTS_DEBUG)
 	if (TheGlobalData->m_debugAI==AI_DEBUG_PATHS)
 	{
@@ -7021,15 +7624,9 @@ Path *Pathfinder::findGroundPath( const Coord3D *from,
 #endif
 	Bool centerInCell = false;
 
-	m_zoneManager.clearPassableFlags();
 	Bool isHuman = true;
 
-	Path *hPat = internal_findHierarchicalPath(isHuman, LOCOMOTORSURFACE_GROUND, from, rawTo, false, false);
-	if (hPat) {
-		deleteInstance(hPat);
-	}	else {
-		m_zoneManager.setAllPassable();
-	}
+	restrictToHierarchicalPath(isHuman, LOCOMOTORSURFACE_GROUND, from, rawTo, false, false);
 
 	if (rawTo->x == 0.0f && rawTo->y == 0.0f) {
 		DEBUG_LOG(("Attempting pathfind to 0,0, generally a bug."));
@@ -7457,6 +8054,126 @@ void Pathfinder::processHierarchicalCell( const ICoord2D &scanCell, const ICoord
 }
 
 
+/**
+ * Expand the hierarchical path around the starting point. jba [8/24/2003]
+ * This allows the unit to get around friendly units that may be near it.
+ */
+void Pathfinder::setPassableAroundPosition( const Coord3D *pos )
+{
+	Coord3D minPos = *pos;
+	minPos.x -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	minPos.y -= PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	Coord3D maxPos = *pos;
+	maxPos.x += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	maxPos.y += PathfindZoneManager::ZONE_BLOCK_SIZE*PATHFIND_CELL_SIZE_F;
+	ICoord2D cellNdxMin, cellNdxMax;
+	worldToCell(&minPos, &cellNdxMin);
+	worldToCell(&maxPos, &cellNdxMax);
+	Int i, j;
+	for (i=cellNdxMin.x; i<=cellNdxMax.x; i++) {
+		for (j=cellNdxMin.y; j<=cellNdxMax.y; j++) {
+			m_zoneManager.setPassable(i, j, true);
+		}
+	}
+}
+
+/**
+ * Get the key of the cached route for a hierarchical path, using the same start and goal cells
+ * as internal_findHierarchicalPath. Returns false if the path can't be cached.
+ */
+Bool Pathfinder::getHierarchicalRouteKey( Bool isHuman, LocomotorSurfaceTypeMask locomotorSurface, const Coord3D *from,
+													 const Coord3D *rawTo, Bool crusher, Bool closestOK, PathfindZoneManager::RouteKey &key)
+{
+	if (rawTo->x == 0.0f && rawTo->y == 0.0f) {
+		return false;
+	}
+	if (m_isMapReady == false) {
+		return false;
+	}
+
+	Coord3D adjustTo = *rawTo;
+	Coord3D clipFrom = *from;
+	clip(&clipFrom, &adjustTo);
+
+	ICoord2D goalCellNdx;
+	worldToCell(&adjustTo, &goalCellNdx);
+	PathfindCell *goalCell = getCell(TheTerrainLogic->getLayerForDestination(&adjustTo), goalCellNdx.x, goalCellNdx.y);
+
+	ICoord2D startCellNdx;
+	worldToCell(&clipFrom, &startCellNdx);
+	PathfindCell *startCell = getCell(TheTerrainLogic->getLayerForDestination(from), startCellNdx.x, startCellNdx.y);
+
+	if (goalCell == NULL || startCell == NULL) {
+		return false;
+	}
+
+	key.startBlock.x = startCellNdx.x/PathfindZoneManager::ZONE_BLOCK_SIZE;
+	key.startBlock.y = startCellNdx.y/PathfindZoneManager::ZONE_BLOCK_SIZE;
+	key.goalBlock.x = goalCellNdx.x/PathfindZoneManager::ZONE_BLOCK_SIZE;
+	key.goalBlock.y = goalCellNdx.y/PathfindZoneManager::ZONE_BLOCK_SIZE;
+	key.startLayer = startCell->getLayer();
+	key.goalLayer = goalCell->getLayer();
+	if (key.startLayer == LAYER_GROUND) {
+		key.startZone = m_zoneManager.getBlockZone(locomotorSurface, crusher, startCellNdx.x, startCellNdx.y, m_map);
+	}	else {
+		key.startZone = startCell->getZone();
+	}
+	if (key.goalLayer == LAYER_GROUND) {
+		key.goalZone = m_zoneManager.getBlockZone(locomotorSurface, crusher, goalCellNdx.x, goalCellNdx.y, m_map);
+	}	else {
+		key.goalZone = goalCell->getZone();
+	}
+	key.surfaces = locomotorSurface;
+	key.isHuman = isHuman;
+	key.crusher = crusher;
+	key.closestOK = closestOK;
+	return true;
+}
+
+/**
+ * Mark only the zone blocks along the hierarchical path as passable, so that the following
+ * search stays near it. If there is no hierarchical path, all blocks are marked passable.
+ * Returns true if a hierarchical path was found.
+ */
+Bool Pathfinder::restrictToHierarchicalPath( Bool isHuman, LocomotorSurfaceTypeMask locomotorSurface, const Coord3D *from,
+													 const Coord3D *to, Bool crusher, Bool closestOK)
+{
+	m_zoneManager.clearPassableFlags();
+
+#if !RETAIL_COMPATIBLE_CRC
+	// Units given the same order search the same route from block to block, so search it only once.
+	// Retail searches it from the exact start and goal cells each time, so only share it when not retail compatible.
+	PathfindZoneManager::RouteKey key;
+	const Bool canCache = getHierarchicalRouteKey(isHuman, locomotorSurface, from, to, crusher, closestOK, key);
+	Bool found = false;
+	if (canCache && m_zoneManager.applyCachedRoute(key, found)) {
+		m_isTunneling = false;
+		if (found) {
+			setPassableAroundPosition(from);
+		}	else {
+			m_zoneManager.setAllPassable();
+		}
+		return found;
+	}
+#endif
+
+	Path *hPat = internal_findHierarchicalPath(isHuman, locomotorSurface, from, to, crusher, closestOK);
+
+#if !RETAIL_COMPATIBLE_CRC
+	if (canCache) {
+		m_zoneManager.cacheRoute(key, hPat != NULL);
+	}
+#endif
+
+	if (hPat) {
+		deleteInstance(hPat);
+		setPassableAroundPosition(from);
+		return true;
+	}
+	m_zoneManager.setAllPassable();
+	return false;
+}
+
 /**
  * Find a short, valid path between given locations.
  * Uses A* algorithm.
@@ -8691,6 +9408,10 @@ Path *Pathfinder::findClosestPath( Object *obj, const LocomotorSet& locomotorSet
 																	Coord3D *rawTo, Bool blocked, Real pathCostMultiplier, Bool moveAllies)
 {
 	//CRCDEBUG_LOG(("Pathfinder::findClosestPath()"));
+	if (m_benchmark && m_isProcessingQueue && m_benchmark->isCapturing()) {
+		m_benchmark->captureRequest(PathfindBenchmark::REQUEST_FIND_CLOSEST_PATH, obj, locomotorSet, from, rawTo,
+			blocked, pathCostMultiplier, moveAllies);
+	}
 #ifdef DEBUG_LOGGING
 	Int startTimeMS = ::GetTickCount();
 #endif
@@ -8794,14 +9515,7 @@ Path *Pathfinder::findClosestPath( Object *obj, const LocomotorSet& locomotorSet
 	if (m_isTunneling) {
 		m_zoneManager.setAllPassable(); // can't optimize.
 	}	else {
-		m_zoneManager.clearPassableFlags();
-		Path *hPat = findClosestHierarchicalPath(isHuman, locomotorSet, from, rawTo, false);
-		if (hPat) {
-			deleteInstance(hPat);
-			gotHierarchicalPath = true;
-		}	else {
-			m_zoneManager.setAllPassable();
-		}
+		gotHierarchicalPath = restrictToHierarchicalPath(isHuman, locomotorSet.getValidSurfaces(), from, rawTo, false, TRUE);
 	}
 	const Bool startedStuck = m_isTunneling;
 
@@ -10673,13 +11387,7 @@ Path *Pathfinder::findAttackPath( const Object *obj, const LocomotorSet& locomot
 	if (obj && obj->getControllingPlayer() && (obj->getControllingPlayer()->getPlayerType()==PLAYER_COMPUTER)) {
 		isHuman = false; // computer gets to cheat.
 	}
-	m_zoneManager.clearPassableFlags();
-	Path *hPat = findClosestHierarchicalPath(isHuman, locomotorSet, from, victimPos, isCrusher);
-	if (hPat) {
-		deleteInstance(hPat);
-	}	else {
-		m_zoneManager.setAllPassable();
-	}
+	restrictToHierarchicalPath(isHuman, locomotorSet.getValidSurfaces(), from, victimPos, isCrusher, TRUE);
 
 	Int cellCount = 0;
 
@@ -0,0 +1,308 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// PathfindBenchmark.cpp
+// Capture and playback of pathfind requests for measuring the pathfinder
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "GameLogic/PathfindBenchmark.h"
+
+#include "Common/crc.h"
+#include "Common/Player.h"
+#include "Common/ThingTemplate.h"
+#include "GameLogic/AIPathfind.h"
+#include "GameLogic/GameLogic.h"
+#include "GameLogic/Object.h"
+#include "GameLogic/Module/AIUpdate.h"
+
+static const char *const RequestTypeNames[PathfindBenchmark::REQUEST_TYPE_COUNT] =
+{
+	"findPath",
+	"findClosestPath",
+	"findHierarchicalPath",
+};
+
+//-------------------------------------------------------------------------------------------------
+PathfindBenchmark::PathfindBenchmark() :
+	m_captureFile(NULL),
+	m_nextRequest(0),
+	m_requestsSkipped(0),
+	m_isRunningRequests(FALSE)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+PathfindBenchmark::~PathfindBenchmark()
+{
+	if (isBenchmarking())
+		report();
+
+	if (m_captureFile != NULL)
+	{
+		fclose(m_captureFile);
+		m_captureFile = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::init( const AsciiString& captureFilename, const AsciiString& benchmarkFilename )
+{
+	if (captureFilename.isNotEmpty())
+	{
+		m_captureFile = fopen(captureFilename.str(), "w");
+		if (m_captureFile == NULL)
+		{
+			DEBUG_CRASH(("Cannot open pathfind capture file '%s'", captureFilename.str()));
+			printf("Cannot open pathfind capture file \"%s\"\n", captureFilename.str());
+		}
+	}
+
+	if (benchmarkFilename.isNotEmpty() && !loadRequests(benchmarkFilename))
+	{
+		DEBUG_CRASH(("Cannot read pathfind benchmark file '%s'", benchmarkFilename.str()));
+		printf("Cannot read pathfind benchmark file \"%s\"\n", benchmarkFilename.str());
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::captureRequest( RequestType type, const Object *obj, const LocomotorSet& locomotorSet,
+	const Coord3D *from, const Coord3D *to, Bool blocked, Real pathCostMultiplier, Bool moveAllies )
+{
+	if (!isCapturing() || obj == NULL)
+		return;
+
+	// %.9g is enough to read back the exact same float.
+	fprintf(m_captureFile, "%u %d %u %s %d %.9g %.9g %.9g %.9g %.9g %.9g %d %.9g %d\n",
+		TheGameLogic->getFrame(),
+		(Int)type,
+		(UnsignedInt)obj->getID(),
+		obj->getTemplate()->getName().str(),
+		(Int)locomotorSet.getValidSurfaces(),
+		from->x, from->y, from->z,
+		to->x, to->y, to->z,
+		blocked ? 1 : 0,
+		pathCostMultiplier,
+		moveAllies ? 1 : 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool PathfindBenchmark::loadRequests( const AsciiString& filename )
+{
+	FILE *file = fopen(filename.str(), "r");
+	if (file == NULL)
+		return FALSE;
+
+	m_requests.clear();
+	m_nextRequest = 0;
+
+	char templateName[256];
+	Request request;
+	Int type, objectID, surfaces, blocked, moveAllies;
+	while (fscanf(file, "%u %d %d %255s %d %f %f %f %f %f %f %d %f %d",
+		&request.frame, &type, &objectID, templateName, &surfaces,
+		&request.from.x, &request.from.y, &request.from.z,
+		&request.to.x, &request.to.y, &request.to.z,
+		&blocked, &request.pathCostMultiplier, &moveAllies) == 14)
+	{
+		if (type < 0 || type >= REQUEST_FIND_HIERARCHICAL_PATH)
+			continue;
+
+		request.type = (RequestType)type;
+		request.objectID = (ObjectID)objectID;
+		request.templateName = templateName;
+		request.surfaces = surfaces;
+		request.blocked = blocked != 0;
+		request.moveAllies = moveAllies != 0;
+		m_requests.push_back(request);
+	}
+
+	fclose(file);
+	return !m_requests.empty();
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::runRequests( Pathfinder *pathfinder, UnsignedInt frame )
+{
+	// Requests of frames that were not reached are lost, for example when the replay is a different one.
+	while (m_nextRequest < m_requests.size() && m_requests[m_nextRequest].frame < frame)
+	{
+		++m_requestsSkipped;
+		++m_nextRequest;
+	}
+
+	if (m_nextRequest >= m_requests.size() || m_requests[m_nextRequest].frame != frame)
+		return;
+
+	// The benchmark runs after the queue, so don't eat into the cell budget of the next frame.
+	const Int cumulativeCellsAllocated = pathfinder->m_cumulativeCellsAllocated;
+	m_isRunningRequests = TRUE;
+
+	// Measure the searches themselves, and leave the route cache as the game left it.
+	pathfinder->m_zoneManager.setRouteCacheBypassed(TRUE);
+
+	for (; m_nextRequest < m_requests.size() && m_requests[m_nextRequest].frame == frame; ++m_nextRequest)
+	{
+		const Request& request = m_requests[m_nextRequest];
+
+		// The captured object has the same ID at the same frame of the same replay.
+		Object *obj = TheGameLogic->findObjectByID(request.objectID);
+		if (obj == NULL || obj->getTemplate()->getName() != request.templateName || obj->getAIUpdateInterface() == NULL)
+		{
+			++m_requestsSkipped;
+			continue;
+		}
+
+		runRequest(pathfinder, request, obj, request.type);
+		if (request.type == REQUEST_FIND_PATH)
+			runRequest(pathfinder, request, obj, REQUEST_FIND_HIERARCHICAL_PATH);
+	}
+
+	pathfinder->m_zoneManager.setRouteCacheBypassed(FALSE);
+
+	m_isRunningRequests = FALSE;
+	pathfinder->m_cumulativeCellsAllocated = cumulativeCellsAllocated;
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::runRequest( Pathfinder *pathfinder, const Request& request, Object *obj, RequestType type )
+{
+	const LocomotorSet& locomotorSet = obj->getAIUpdateInterface()->getLocomotorSet();
+	Coord3D to = request.to;
+
+	pathfinder->m_cumulativeCellsAllocated = 0;
+	const double startSeconds = getSeconds();
+
+	Path *path = NULL;
+	switch (type)
+	{
+		case REQUEST_FIND_PATH:
+			path = pathfinder->findPath(obj, locomotorSet, &request.from, &to);
+			break;
+		case REQUEST_FIND_CLOSEST_PATH:
+			// Moving allies would change the game state, so the replay would no longer match.
+			path = pathfinder->findClosestPath(obj, locomotorSet, &request.from, &to,
+				request.blocked, request.pathCostMultiplier, FALSE);
+			break;
+		case REQUEST_FIND_HIERARCHICAL_PATH:
+		{
+			Bool isHuman = true;
+			if (obj->getControllingPlayer() && obj->getControllingPlayer()->getPlayerType() == PLAYER_COMPUTER)
+				isHuman = false;
+			pathfinder->m_zoneManager.clearPassableFlags();
+			path = pathfinder->findHierarchicalPath(isHuman, locomotorSet, &request.from, &to, false);
+			pathfinder->m_zoneManager.setAllPassable();
+			break;
+		}
+	}
+
+	Results& results = m_results[type];
+	results.seconds.push_back(getSeconds() - startSeconds);
+	results.cellsExamined += pathfinder->m_cumulativeCellsAllocated;
+
+	// Mix the hash of every path, so that any difference in any path changes the total.
+	const UnsignedInt pathHash = computePathHash(path);
+	results.pathHash = (results.pathHash << 1 | results.pathHash >> 31) + pathHash;
+
+	if (path != NULL)
+	{
+		++results.pathsFound;
+		deleteInstance(path);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+UnsignedInt PathfindBenchmark::computePathHash( Path *path )
+{
+	if (path == NULL)
+		return 0;
+
+	CRC crc;
+	for (PathNode *node = path->getFirstNode(); node != NULL; node = node->getNext())
+	{
+		const Coord3D *pos = node->getPosition();
+		const Int layer = node->getLayer();
+		crc.computeCRC(pos, sizeof(Coord3D));
+		crc.computeCRC(&layer, sizeof(layer));
+	}
+	return crc.get();
+}
+
+//-------------------------------------------------------------------------------------------------
+double PathfindBenchmark::getSeconds( void )
+{
+	static double s_secondsPerTick = 0.0;
+	if (s_secondsPerTick == 0.0)
+	{
+		__int64 freq64;
+		QueryPerformanceFrequency((LARGE_INTEGER *)&freq64);
+		s_secondsPerTick = 1.0 / (double)freq64;
+	}
+
+	__int64 time64;
+	QueryPerformanceCounter((LARGE_INTEGER *)&time64);
+	return (double)time64 * s_secondsPerTick;
+}
+
+//-------------------------------------------------------------------------------------------------
+void PathfindBenchmark::report( void )
+{
+	Int i;
+
+	Bool hasResults = m_requestsSkipped != 0;
+	for (i = 0; i < REQUEST_TYPE_COUNT; ++i)
+		hasResults |= !m_results[i].seconds.empty();
+	if (!hasResults)
+		return;
+
+	// Note that we use printf here because this is run from cmd.
+	printf("Pathfind benchmark: %d requests skipped\n", m_requestsSkipped);
+
+	for (i = 0; i < REQUEST_TYPE_COUNT; ++i)
+	{
+		Results& results = m_results[i];
+		const size_t count = results.seconds.size();
+		if (count == 0)
+			continue;
+
+		std::sort(results.seconds.begin(), results.seconds.end());
+		double totalSeconds = 0.0;
+		for (size_t j = 0; j < count; ++j)
+			totalSeconds += results.seconds[j];
+
+		const double p50 = results.seconds[(count - 1) * 50 / 100] * 1000.0;
+		const double p90 = results.seconds[(count - 1) * 90 / 100] * 1000.0;
+		const double p99 = results.seconds[(count - 1) * 99 / 100] * 1000.0;
+		const double max = results.seconds[count - 1] * 1000.0;
+		const double cellsPerSecond = totalSeconds > 0.0 ? results.cellsExamined / totalSeconds : 0.0;
+
+		printf("%s: %d requests, %d paths found, hash %8.8X\n",
+			RequestTypeNames[i], (Int)count, results.pathsFound, results.pathHash);
+		printf("   ms p50 %.3f p90 %.3f p99 %.3f max %.3f total %.1f\n",
+			p50, p90, p99, max, totalSeconds * 1000.0);
+		printf("   cells examined %d, %.0f cells/s\n", results.cellsExamined, cellsPerSecond);
+
+		DEBUG_LOG(("Pathfind benchmark %s: %d requests, %d found, hash %8.8X, ms p50 %.3f p90 %.3f p99 %.3f max %.3f, %d cells",
+			RequestTypeNames[i], (Int)count, results.pathsFound, results.pathHash, p50, p90, p99, max, results.cellsExamined));
+
+		results = Results();
+	}
+	fflush(stdout);
+
+	m_requestsSkipped = 0;
+}
@@ -33,6 +33,7 @@
 #include "Common/MapReaderWriterInfo.h"
 #include "Common/Xfer.h"
 #include "GameLogic/PolygonTrigger.h"
+#include "GameLogic/Scripts.h"
 #include "GameLogic/TerrainLogic.h"
 
 /* ********* PolygonTrigger class ****************************/
@@ -305,6 +306,7 @@ void PolygonTrigger::addPolygonTrigger(PolygonTrigger *pTrigger)
 	}
 	pTrigger->m_nextPolygonTrigger = ThePolygonTriggerListPtr;
 	ThePolygonTriggerListPtr = pTrigger;
+	Parameter::invalidateBoundHandles();
 }
 
 /**
@@ -330,6 +332,7 @@ void PolygonTrigger::removePolygonTrigger(PolygonTrigger *pTrigger)
 		}
 	}
 	pTrigger->m_nextPolygonTrigger = NULL;
+	Parameter::invalidateBoundHandles();
 }
 
 /**
@@ -341,6 +344,7 @@ void PolygonTrigger::deleteTriggers(void)
 	ThePolygonTriggerListPtr = NULL;
 	s_currentID = 1;
 	deleteInstance(pList);
+	Parameter::invalidateBoundHandles();
 }
 
 /**
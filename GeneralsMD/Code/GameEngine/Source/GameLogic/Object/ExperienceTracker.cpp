@@ -92,6 +92,7 @@ void ExperienceTracker::setMinVeterancyLevel( VeterancyLevel newLevel, Bool prov
 		VeterancyLevel oldLevel = m_currentLevel;
 		m_currentLevel = newLevel;
 		m_currentExperience = m_parent->getTemplate()->getExperienceRequired(m_currentLevel); //Minimum for this level
+		m_parent->markCRCDirty();
 		if (m_parent)
 			m_parent->onVeterancyLevelChanged( oldLevel, newLevel, provideFeedback );
 	}
@@ -108,6 +109,7 @@ void ExperienceTracker::setVeterancyLevel( VeterancyLevel newLevel, Bool provide
 		VeterancyLevel oldLevel = m_currentLevel;
 		m_currentLevel = newLevel;
 		m_currentExperience = m_parent->getTemplate()->getExperienceRequired(m_currentLevel); //Minimum for this level
+		m_parent->markCRCDirty();
 		if (m_parent)
 			m_parent->onVeterancyLevelChanged( oldLevel, newLevel, provideFeedback );
 	}
@@ -165,6 +167,7 @@ void ExperienceTracker::addExperiencePoints( Int experienceGain, Bool canScaleFo
 
 
 	m_currentExperience += amountToGain;
+	m_parent->markCRCDirty();
 
 	Int levelIndex = 0;
 	while( ( (levelIndex + 1) < LEVEL_COUNT)
@@ -205,6 +208,7 @@ void ExperienceTracker::setExperienceAndLevel( Int experienceIn, Bool provideFee
 	VeterancyLevel oldLevel = m_currentLevel;
 
 	m_currentExperience = experienceIn;
+	m_parent->markCRCDirty();
 
 	Int levelIndex = 0;
 	while( ( (levelIndex + 1) < LEVEL_COUNT)
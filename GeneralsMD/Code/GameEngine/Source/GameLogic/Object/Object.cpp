@@ -212,6 +212,8 @@ Object::Object( const ThingTemplate *tt, const ObjectStatusMaskType &objectStatu
 	m_formationID(NO_FORMATION_ID),
 	m_isReceivingDifficultyBonus(FALSE),
 	m_singleUseCommandUsed(FALSE),
+	m_cachedCRC(0),
+	m_isCRCDirty(TRUE),
 	m_scriptStatus(0),
 	m_enteredOrExitedFrame(0),
 	m_visionSpiedMask (PLAYERMASK_NONE),
@@ -790,6 +792,7 @@ void Object::setGeometryInfoZ( Real newZ )
 //=============================================================================
 void Object::friend_setUndetectedDefector( Bool status )
 {
+	markCRCDirty();
 	if (status)
 		m_privateStatus |= UNDETECTED_DEFECTOR;
 	else
@@ -1757,6 +1760,7 @@ void Object::reactToTurretChange( WhichTurretType turret, Real oldRotation, Real
 void Object::reactToTransformChange(const Matrix3D* oldMtx, const Coord3D* oldPos, Real oldAngle)
 {
 	//USE_PERF_TIMER(Object_reactToTransformChange)
+	markCRCDirty();
 	if(_isnan(getPosition()->x) || _isnan(getPosition()->y) || _isnan(getPosition()->z)) {
 		DEBUG_CRASH(("Object pos is nan."));
 		TheGameLogic->destroyObject(this);
@@ -1977,6 +1981,7 @@ void Object::healCompletely()
 //-------------------------------------------------------------------------------------------------
 void Object::setEffectivelyDead(Bool dead)
 {
+	markCRCDirty();
 	if (dead)
 		BitSet(m_privateStatus, EFFECTIVELY_DEAD);
 	else
@@ -1992,6 +1997,7 @@ void Object::setEffectivelyDead(Bool dead)
 //-------------------------------------------------------------------------------------------------
 void Object::setCaptured(Bool isCaptured)
 {
+	markCRCDirty();
 	if (isCaptured)
 		BitSet(m_privateStatus, CAPTURED);
 	else
@@ -2827,6 +2833,8 @@ void Object::friend_notifyOfNewMapBoundary(void)
 	// Now that the PartitionManager has finished its reset, we need to relook
 	handlePartitionCellMaintenance();
 
+	markCRCDirty();
+
 	Region3D mapExtent;
 	TheTerrainLogic->getExtent(&mapExtent);
 	if (mapExtent.isInRegionNoZ(getPosition()))
@@ -4477,6 +4485,7 @@ void Object::giveUpgrade( const UpgradeTemplate *upgradeT )
 	if (upgradeT)
 	{
 		m_objectUpgradesCompleted.set( upgradeT->getUpgradeMask() );
+		markCRCDirty();
 
 		//
 		// iterate through all the upgrade modules of this object and call the method to
@@ -4492,6 +4501,7 @@ void Object::giveUpgrade( const UpgradeTemplate *upgradeT )
 void Object::removeUpgrade( const UpgradeTemplate *upgradeT )
 {
 	m_objectUpgradesCompleted.clear( upgradeT->getUpgradeMask() );
+	markCRCDirty();
 	for (BehaviorModule** module = m_behaviors; *module; ++module)
 	{
 		UpgradeModuleInterface* upgrade = (*module)->getUpgrade();
@@ -4657,6 +4667,7 @@ void Object::setWeaponBonusCondition(WeaponBonusConditionType wst)
 	{
 		// Our weapon bonus just changed, so we need to immediately update our weapons
 		m_weaponSet.weaponSetOnWeaponBonusChange(this);
+		markCRCDirty();
 	}
 }
 
@@ -4670,6 +4681,7 @@ void Object::clearWeaponBonusCondition(WeaponBonusConditionType wst)
 	{
 		// Our weapon bonus just changed, so we need to immediately update our weapons
 		m_weaponSet.weaponSetOnWeaponBonusChange(this);
+		markCRCDirty();
 	}
 }
 
@@ -88,6 +88,11 @@
 #include "Common/MapObject.h"
 #endif
 
+#if defined(FASTER_GCO) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__))
+#define GCO_USE_SSE
+#include <xmmintrin.h>
+#endif
+
 #ifdef DUMP_PERF_STATS
 	long s_countInClosestObjects = 0;
 	long s_countInClosestObjectsThisFrame = 0;
@@ -959,6 +964,20 @@ static DistCalcProc theDistCalcProcs[] =
 	distCalcProc_BoundaryAndBoundary_3D,
 };
 
+#ifdef FASTER_GCO
+// NOTE: This *DEPENDS* on the order of the RangeQueryCacheUser enum
+static const char *const TheRangeQueryCacheUserNames[] =
+{
+	"FindClosestEnemy",
+	"StealthDetector",
+	"AutoFindHealing",
+};
+static_assert(ARRAY_SIZE(TheRangeQueryCacheUserNames) == RANGE_QUERY_USER_COUNT, "Incorrect array size");
+
+// used by getClosestObjects and the range query cache to visit every object only once.
+static Int theGcoIterFlag = 1;	// nonzero, thanks
+#endif
+
 // NOTE: This *DEPENDS* on the order of the geometry enum defines
 static CollideTestProc theCollideTestProcs[] =
 {
@@ -982,20 +1001,18 @@ PartitionManager *ThePartitionManager = NULL;  ///< the object manager singleton
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
-class PartitionContactListNode : public MemoryPoolObject
+/**
+	A pair of possibly colliding objects. The contacts of a frame are kept in one array,
+	so that recording a pair needs no allocation and processing them walks contiguous memory.
+*/
+struct PartitionContactListNode
 {
-	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(PartitionContactListNode, "PartitionContactListNode" )
-
-public:
-	PartitionContactListNode*			m_nextHash;	///< next node with same hash value
-	PartitionContactListNode*			m_next;			///< next node
+	Int														m_nextHash;	///< index of the next node with same hash value, or -1
 	PartitionData*								m_obj;			///< one object that is possibly colliding
 	PartitionData*								m_other;		///< the other object (or null for collisions with the terrain)
 	Int														m_hashValue;///< index into hash table
 };
 
-inline PartitionContactListNode::~PartitionContactListNode() { }
-
 //-----------------------------------------------------------------------------
 
 class PartitionContactList
@@ -1013,15 +1030,17 @@ private:
 	enum { PartitionContactList_SOCKET_COUNT = 5381 };
 
 
-	PartitionContactListNode* m_contactHash[PartitionContactList_SOCKET_COUNT];
-	PartitionContactListNode* m_contactList;
+	enum { NO_CONTACT = -1 };
+
+	Int m_contactHash[PartitionContactList_SOCKET_COUNT];	///< index of the first node with this hash value, or NO_CONTACT
+	std::vector<PartitionContactListNode> m_contactList;	///< in the order they were added, but processed in reverse
 
 public:
 
 	PartitionContactList()
 	{
-		memset(m_contactHash, 0, sizeof(m_contactHash));
-		m_contactList = NULL;
+		for (Int i = 0; i < PartitionContactList_SOCKET_COUNT; ++i)
+			m_contactHash[i] = NO_CONTACT;
 	}
 
 	~PartitionContactList()
@@ -1045,7 +1064,7 @@ public:
 	void processContactList();
 
 	/**
-		discard the contents of the contact list.
+		discard the contents of the contact list. The memory is kept for the next frame.
 	*/
 	void resetContactList();
 
@@ -1467,6 +1486,7 @@ void PartitionCell::friend_addToCellList(CellAndObjectIntersection *coi)
 	{
 		coi->friend_addToCellList(&m_firstCoiInCell);
 		++m_coiCount;
+		ThePartitionManager->invalidateRangeQueryCache();
 	}
 }
 
@@ -1477,6 +1497,7 @@ void PartitionCell::friend_removeFromCellList(CellAndObjectIntersection *coi)
 	{
 		coi->friend_removeFromCellList(&m_firstCoiInCell);
 		--m_coiCount;
+		ThePartitionManager->invalidateRangeQueryCache();
 	}
 }
 
@@ -2391,35 +2412,34 @@ void PartitionContactList::addToContactList( PartitionData *obj, PartitionData *
 	hashValue %= PartitionContactList_SOCKET_COUNT;
 
 	// make sure given hit has not already been recorded
-	for (PartitionContactListNode* cd = m_contactHash[ hashValue ]; cd; cd = cd->m_nextHash )
+	for (Int index = m_contactHash[ hashValue ]; index != NO_CONTACT; index = m_contactList[ index ].m_nextHash )
 	{
-		if ((cd->m_obj == obj && cd->m_other == other) ||
-				(cd->m_obj == other && cd->m_other == obj))
+		const PartitionContactListNode& cd = m_contactList[ index ];
+		if ((cd.m_obj == obj && cd.m_other == other) ||
+				(cd.m_obj == other && cd.m_other == obj))
 		{
 			// already noted
 			return;
 		}
 	}
 
-	// new hit
-	PartitionContactListNode *ncd = newInstance(PartitionContactListNode);
-	ncd->m_obj = obj;
-	ncd->m_other = other;
-	ncd->m_hashValue = hashValue;
+	// new hit, add to list of contacts for this frame
+	PartitionContactListNode ncd;
+	ncd.m_obj = obj;
+	ncd.m_other = other;
+	ncd.m_hashValue = hashValue;
 
 	// add to hash table
-	ncd->m_nextHash = m_contactHash[ hashValue ];
-	m_contactHash[ hashValue ] = ncd;
+	ncd.m_nextHash = m_contactHash[ hashValue ];
+	m_contactHash[ hashValue ] = (Int)m_contactList.size();
 
-	// add to list of contacts for this frame
-	ncd->m_next = m_contactList;
-	m_contactList = ncd;
+	m_contactList.push_back(ncd);
 
 
 #if 0
 
 Int depth = 0;
-for (PartitionContactListNode *cd2 = m_contactHash[ hashValue ]; cd2; cd2 = cd2->m_nextHash )
+for (Int index2 = m_contactHash[ hashValue ]; index2 != NO_CONTACT; index2 = m_contactList[ index2 ].m_nextHash )
 {
 	depth++;
 }
@@ -2430,8 +2450,9 @@ if (depth > 3)
 		other_obj->getTemplate()->getName().str(),other_obj,other_obj->getID()
 		));
 
-	for (cd2 = m_contactHash[ hashValue ]; cd2; cd2 = cd2->m_nextHash )
+	for (index2 = m_contactHash[ hashValue ]; index2 != NO_CONTACT; index2 = m_contactList[ index2 ].m_nextHash )
 	{
+		PartitionContactListNode *cd2 = &m_contactList[ index2 ];
 		UnsignedInt rawhash = djb2hash2ints(cd2->m_obj->getObject()->getID(), cd2->m_other->getObject()->getID());
 		//hashValue %= PartitionContactList_SOCKET_COUNT;
 
@@ -2448,10 +2469,10 @@ static Real aggfull = 0;
 static Real aggcount = 0;
 for (int ii = 0; ii < PartitionContactList_SOCKET_COUNT; ++ii)
 {
-	if (m_contactHash[ii])
+	if (m_contactHash[ii] != NO_CONTACT)
 		aggfull += 1.0f;
 
-	for (cd2 = m_contactHash[ ii ]; cd2; cd2 = cd2->m_nextHash )
+	for (index2 = m_contactHash[ ii ]; index2 != NO_CONTACT; index2 = m_contactList[ index2 ].m_nextHash )
 	{
 		aggtotal += 1.0f;
 	}
@@ -2467,8 +2488,10 @@ aggcount,aggtotal/(aggcount*PartitionContactList_SOCKET_COUNT),(aggfull*100)/(ag
 //-----------------------------------------------------------------------------
 void PartitionContactList::removeSpecificPartitionData(PartitionData* data)
 {
-	for (PartitionContactListNode* cd = m_contactList; cd; cd = cd->m_next)
+	const Int count = (Int)m_contactList.size();
+	for (Int i = 0; i < count; ++i)
 	{
+		PartitionContactListNode* cd = &m_contactList[i];
 		if (cd->m_obj == data || cd->m_other == data)
 		{
 			cd->m_obj = NULL;
@@ -2480,23 +2503,23 @@ void PartitionContactList::removeSpecificPartitionData(PartitionData* data)
 //-----------------------------------------------------------------------------
 void PartitionContactList::resetContactList()
 {
-	// remove items from hash table
-	PartitionContactListNode* cdnext;
-	for (PartitionContactListNode* cd = m_contactList; cd; cd = cdnext)
+	// remove items from hash table. only the used sockets need it.
+	const Int count = (Int)m_contactList.size();
+	for (Int i = 0; i < count; ++i)
 	{
-		cdnext = cd->m_next;
-		deleteInstance(cd);
+		m_contactHash[ m_contactList[i].m_hashValue ] = NO_CONTACT;
 	}
 
-	memset(m_contactHash, 0, sizeof(m_contactHash));
-	m_contactList = NULL;
+	m_contactList.clear();
 }
 
 //-----------------------------------------------------------------------------
 void PartitionContactList::processContactList()
 {
-	for (PartitionContactListNode* cd = m_contactList; cd; cd = cd->m_next)
+	// newest first, like the contacts have always been processed.
+	for (Int i = (Int)m_contactList.size() - 1; i >= 0; --i)
 	{
+		PartitionContactListNode* cd = &m_contactList[i];
 		if (cd->m_obj == NULL || cd->m_other == NULL)
 			continue;
 
@@ -2572,6 +2595,16 @@ PartitionManager::PartitionManager()
 	m_updatedSinceLastReset = false;
 #ifdef FASTER_GCO
 	m_maxGcoRadius = 0;
+	for (Int i = 0; i < RANGE_QUERY_CACHE_SIZE; ++i)
+	{
+		m_rangeQueryCache[i].stamp = 0;
+	}
+	m_rangeQueryCacheStamp = 1;
+	for (Int j = 0; j < RANGE_QUERY_USER_COUNT; ++j)
+	{
+		m_rangeQueryCacheHits[j] = 0;
+		m_rangeQueryCacheMisses[j] = 0;
+	}
 #endif
 }
 
@@ -2689,6 +2722,21 @@ void PartitionManager::reset()
 	s_gcoPerfFrame = 0xffffffff;
 #endif
 
+#ifdef FASTER_GCO
+	for (Int i = 0; i < RANGE_QUERY_USER_COUNT; ++i)
+	{
+		const UnsignedInt total = m_rangeQueryCacheHits[i] + m_rangeQueryCacheMisses[i];
+		if (total != 0)
+		{
+			DEBUG_LOG(("Range query cache %s: %d of %d queries hit (%.1f%%)", TheRangeQueryCacheUserNames[i],
+				m_rangeQueryCacheHits[i], total, 100.0 * m_rangeQueryCacheHits[i] / total));
+		}
+		m_rangeQueryCacheHits[i] = 0;
+		m_rangeQueryCacheMisses[i] = 0;
+	}
+	invalidateRangeQueryCache();
+#endif
+
 	resetPendingUndoShroudRevealQueue();
 
 	shutdown();
@@ -2730,11 +2778,38 @@ void PartitionManager::shutdown()
 	m_worldExtents.hi.zero();
 }
 
+#if !RETAIL_COMPATIBLE_CRC
+//-----------------------------------------------------------------------------
+static Int getPartitionDataCellIndex(PartitionData *data)
+{
+	PartitionCell *cell = data->friend_getFirstCellTouched();
+	if (cell == NULL)
+		return -1;
+	return cell->getCellY() * ThePartitionManager->getCellCountX() + cell->getCellX();
+}
+
+//-----------------------------------------------------------------------------
+static bool comparePartitionDataByCell(PartitionData *a, PartitionData *b)
+{
+	const Int cellA = getPartitionDataCellIndex(a);
+	const Int cellB = getPartitionDataCellIndex(b);
+	if (cellA != cellB)
+		return cellA < cellB;
+
+	// the order must not depend on the memory layout, to stay deterministic.
+	return a->getObject()->getID() < b->getObject()->getID();
+}
+#endif
+
 //-----------------------------------------------------------------------------
 //DECLARE_PERF_TIMER(PartitionManager_update)
 void PartitionManager::update()
 {
 	//USE_PERF_TIMER(PartitionManager_update)
+
+	// the objects have moved since the last frame, so don't hand out their old candidates.
+	invalidateRangeQueryCache();
+
 	{
 #ifdef INTENSE_DEBUG
 		Int cc = 0;
@@ -2744,8 +2819,16 @@ void PartitionManager::update()
 			m_updatedSinceLastReset = true;
 		}
 
-		PartitionContactList ctList;
+		// kept from frame to frame, so that its memory is reused.
+		static PartitionContactList ctList;
 		TheContactList = &ctList;
+
+#if !RETAIL_COMPATIBLE_CRC
+		// the modules to check for collisions, once all of the cells are up to date.
+		static std::vector<PartitionData *> collideModules;
+		collideModules.clear();
+#endif
+
 		while (m_dirtyModules)
 		{
 #ifdef INTENSE_DEBUG
@@ -2772,11 +2855,27 @@ void PartitionManager::update()
 
 			if (collideEm && !dirty->getObject()->isKindOf(KINDOF_IMMOBILE))
 			{
+#if RETAIL_COMPATIBLE_CRC
 				dirty->addPossibleCollisions(&ctList);
+#else
+				collideModules.push_back(dirty);
+#endif
 			}
 		}
 
+#if !RETAIL_COMPATIBLE_CRC
+		// TheSuperHackers @performance Gather the possible collisions in cell order, so that neighbouring
+		// objects walk the same cells one after the other. Every object sees the cells of this frame now,
+		// instead of the ones of the objects that happened to come later in the dirty list.
+		std::sort(collideModules.begin(), collideModules.end(), comparePartitionDataByCell);
+		for (std::vector<PartitionData *>::const_iterator it = collideModules.begin(); it != collideModules.end(); ++it)
+		{
+			(*it)->addPossibleCollisions(&ctList);
+		}
+#endif
+
 		ctList.processContactList();
+		ctList.resetContactList();
 #ifdef INTENSE_DEBUG
 		DEBUG_ASSERTLOG(cc==0,("updated partition info for %d objects",cc));
 #endif
@@ -3213,6 +3312,99 @@ void PartitionManager::calcRadiusVec()
 }
 #endif
 
+//-----------------------------------------------------------------------------
+#ifdef FASTER_GCO
+/*
+	getClosestObjects gathers the candidates of a cell into these arrays, so that the ones
+	that are clearly out of range are rejected several at a time, before the exact distance
+	calculation and the filters run on the remaining ones.
+*/
+enum { GCO_BATCH_SIZE = 64 };
+
+struct GcoBatch
+{
+	Int count;
+	Object *objects[GCO_BATCH_SIZE];
+	Real x[GCO_BATCH_SIZE];
+	Real y[GCO_BATCH_SIZE];
+	Real radius[GCO_BATCH_SIZE];	///< the radius that the distance calculation subtracts, if any
+};
+
+//-----------------------------------------------------------------------------
+/**
+	Compact the batch to the candidates that may be closer than maxDist, keeping their order.
+	This only rejects candidates that the distance calculation would reject too: the 2D
+	distance is never larger than the 3D one, and the reach includes some slack so that
+	differences in float precision can't reject a candidate that is in range.
+*/
+static Int rejectGcoCandidatesOutOfRange(GcoBatch& batch, Real centerX, Real centerY, Real centerRadius, Real maxDist)
+{
+	const Real REACH_SLACK_SCALE = 1.01f;
+	const Real REACH_SLACK_ADD = 1.0f;
+
+	const Real reachBase = maxDist + centerRadius;
+	const Int count = batch.count;
+	Int kept = 0;
+	Int i = 0;
+
+#ifdef GCO_USE_SSE
+	const __m128 cx = _mm_set1_ps(centerX);
+	const __m128 cy = _mm_set1_ps(centerY);
+	const __m128 base = _mm_set1_ps(reachBase);
+	const __m128 scale = _mm_set1_ps(REACH_SLACK_SCALE);
+	const __m128 add = _mm_set1_ps(REACH_SLACK_ADD);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&batch.x[i]), cx);
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&batch.y[i]), cy);
+		const __m128 distSqr = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		const __m128 reach = _mm_add_ps(_mm_mul_ps(_mm_add_ps(base, _mm_loadu_ps(&batch.radius[i])), scale), add);
+
+		// a NaN compares as not greater, so it is kept for the exact calculation to deal with.
+		const Int outOfRange = _mm_movemask_ps(_mm_cmpgt_ps(distSqr, _mm_mul_ps(reach, reach)));
+		if (outOfRange == 0xf)
+			continue;
+
+		for (Int j = 0; j < 4; ++j)
+		{
+			if ((outOfRange & (1 << j)) == 0)
+				batch.objects[kept++] = batch.objects[i + j];
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		const Real dx = batch.x[i] - centerX;
+		const Real dy = batch.y[i] - centerY;
+		const Real reach = (reachBase + batch.radius[i]) * REACH_SLACK_SCALE + REACH_SLACK_ADD;
+		if (!(dx*dx + dy*dy > reach*reach))
+			batch.objects[kept++] = batch.objects[i];
+	}
+
+	batch.count = kept;
+	return kept;
+}
+
+//-----------------------------------------------------------------------------
+/// the radius that the distance calculation of dc subtracts from the distance of obj.
+inline Real getGcoRadius(const Object *obj, DistanceCalculationType dc)
+{
+	if (obj == NULL)
+		return 0.0f;
+
+	switch (dc)
+	{
+		case FROM_BOUNDINGSPHERE_2D:
+			return obj->getGeometryInfo().getBoundingCircleRadius();
+		case FROM_BOUNDINGSPHERE_3D:
+			return obj->getGeometryInfo().getBoundingSphereRadius();
+		default:
+			return 0.0f;
+	}
+}
+#endif
+
 //-----------------------------------------------------------------------------
 //DECLARE_PERF_TIMER(getClosestObjects)
 Object *PartitionManager::getClosestObjects(
@@ -3223,7 +3415,8 @@ Object *PartitionManager::getClosestObjects(
 	PartitionFilter **filters,
 	SimpleObjectIterator *iterArg,	// if nonnull, append ALL satisfactory objects to the iterator (not just the single closest)
 	Real *closestDistArg,
-	Coord3D *closestVecArg
+	Coord3D *closestVecArg,
+	RangeQueryCacheUser cacheUser
 )
 {
 	//USE_PERF_TIMER(getClosestObjects)
@@ -3278,6 +3471,8 @@ Object *PartitionManager::getClosestObjects(
 
 #ifdef FASTER_GCO
 
+	const Real objRadius = getGcoRadius(objToUse, dc);
+
 	Int maxRadius = m_maxGcoRadius;
 	if (maxDist < HUGE_DIST)
 	{
@@ -3297,73 +3492,140 @@ Object *PartitionManager::getClosestObjects(
 
 	Bool foundAny = false;
 
-	static Int theIterFlag = 1;	// nonzero, thanks
-	++theIterFlag;
-
-	/*
-		m_radiusVec[curRadius] contains a list of the cells (foo) that could
-		contain objects that are <= (curRadius * cellSize) distance away from cell (0,0).
-	*/
-  for (Int curRadius = 0; curRadius <= maxRadiusLimit; ++curRadius)
-  {
-    const OffsetVec& offsets = m_radiusVec[curRadius];
-		if (offsets.empty())
-			continue;
-    for (OffsetVec::const_iterator it = offsets.begin(); it != offsets.end(); ++it)
+	if (cacheUser != RANGE_QUERY_NOT_CACHED)
+	{
+		// the cached candidates are in the same order as the cells are visited below, so examining
+		// them the same way gives the same result.
+		const RangeQueryCandidateVec& candidates = getRangeQueryCandidates(cellCenterX, cellCenterY, maxRadiusLimit, cacheUser);
+		for (RangeQueryCandidateVec::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
 		{
-			PartitionCell* thisCell = getCellAt(cellCenterX + it->x, cellCenterY + it->y);
-			if (thisCell == NULL)
-				continue;
+			if (it->radius > maxRadiusLimit)
+				break;
 
-			for (CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell(); thisCoi; thisCoi = thisCoi->getNextCoi())
-			{
-				PartitionData *thisMod = thisCoi->getModule();
-				Object *thisObj = thisMod->getObject();
+			Object *thisObj = it->obj;
 
-				// never compare against ourself.
-				if (thisObj == obj || thisObj == NULL)
-					continue;
+			// never compare against ourself.
+			if (thisObj == obj)
+				continue;
 
-				// since an object can exist in multiple COIs, we use this to avoid processing
-				// the same one more than once.
-				if (thisMod->friend_getDoneFlag() == theIterFlag)
-					continue;
-				thisMod->friend_setDoneFlag(theIterFlag);
+			Real thisDistSqr;
+			Coord3D distVec;
+			if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, closestDistSqr))
+				continue;
 
-				Real thisDistSqr;
-				Coord3D distVec;
-				if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, closestDistSqr))
-					continue;
+			if (!filtersAllow(filters, thisObj))
+				continue;
 
-				if (!filtersAllow(filters, thisObj))
-					continue;
+			if (iterArg)
+			{
+				iterArg->insert(thisObj, thisDistSqr);
+			}
+			else
+			{
+				closestObj = thisObj;
+				closestDistSqr = thisDistSqr;
+				closestVec = distVec;
 
-				// ok, this is within the range, and the filters allow it.
-				// add it to the iter, if we have one....
-				if (iterArg)
+				if (!foundAny)
 				{
-					iterArg->insert(thisObj, thisDistSqr);
+					// if not adding to iterArg, we want to stop once we have the closest object.
+					maxRadiusLimit = it->radius;
 				}
-				else
+				foundAny = true;
+			}
+		}
+	}
+	else
+	{
+		GcoBatch batch;
+
+		++theGcoIterFlag;
+
+		/*
+			m_radiusVec[curRadius] contains a list of the cells (foo) that could
+			contain objects that are <= (curRadius * cellSize) distance away from cell (0,0).
+		*/
+	  for (Int curRadius = 0; curRadius <= maxRadiusLimit; ++curRadius)
+	  {
+	    const OffsetVec& offsets = m_radiusVec[curRadius];
+			if (offsets.empty())
+				continue;
+	    for (OffsetVec::const_iterator it = offsets.begin(); it != offsets.end(); ++it)
+			{
+				PartitionCell* thisCell = getCellAt(cellCenterX + it->x, cellCenterY + it->y);
+				if (thisCell == NULL)
+					continue;
+
+				CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell();
+				while (thisCoi)
 				{
-					// hey, this is the new closest object! cool.
-					// (note that we can't break out now 'cuz we have to finish examining the
-					// rest of curRadius)
-					closestObj = thisObj;
-					closestDistSqr = thisDistSqr;
-					closestVec = distVec;
-
-					if (!foundAny)
+					// gather the next batch of candidates of this cell.
+					batch.count = 0;
+					for (; thisCoi && batch.count < GCO_BATCH_SIZE; thisCoi = thisCoi->getNextCoi())
 					{
-						// if not adding to iterArg, we want to stop once we have the closest object.
-						maxRadiusLimit = curRadius;
+						PartitionData *thisMod = thisCoi->getModule();
+						Object *thisObj = thisMod->getObject();
+
+						// never compare against ourself.
+						if (thisObj == obj || thisObj == NULL)
+							continue;
+
+						// since an object can exist in multiple COIs, we use this to avoid processing
+						// the same one more than once.
+						if (thisMod->friend_getDoneFlag() == theGcoIterFlag)
+							continue;
+						thisMod->friend_setDoneFlag(theGcoIterFlag);
+
+						const Coord3D *thisPos = thisObj->getPosition();
+						batch.objects[batch.count] = thisObj;
+						batch.x[batch.count] = thisPos->x;
+						batch.y[batch.count] = thisPos->y;
+						batch.radius[batch.count] = getGcoRadius(thisObj, dc);
+						++batch.count;
 					}
-					foundAny = true;
-				}
 
-			} // next coi
-		}	// next cell in this radius
-  } // next radius
+					const Int candidateCount = rejectGcoCandidatesOutOfRange(batch, objPos->x, objPos->y, objRadius, sqrtf(closestDistSqr));
+
+					for (Int candidate = 0; candidate < candidateCount; ++candidate)
+					{
+						Object *thisObj = batch.objects[candidate];
+
+						Real thisDistSqr;
+						Coord3D distVec;
+						if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, closestDistSqr))
+							continue;
+
+						if (!filtersAllow(filters, thisObj))
+							continue;
+
+						// ok, this is within the range, and the filters allow it.
+						// add it to the iter, if we have one....
+						if (iterArg)
+						{
+							iterArg->insert(thisObj, thisDistSqr);
+						}
+						else
+						{
+							// hey, this is the new closest object! cool.
+							// (note that we can't break out now 'cuz we have to finish examining the
+							// rest of curRadius)
+							closestObj = thisObj;
+							closestDistSqr = thisDistSqr;
+							closestVec = distVec;
+
+							if (!foundAny)
+							{
+								// if not adding to iterArg, we want to stop once we have the closest object.
+								maxRadiusLimit = curRadius;
+							}
+							foundAny = true;
+						}
+
+					} // next candidate
+				} // next batch of cois
+			}	// next cell in this radius
+	  } // next radius
+	}
 
 #else // not FASTER_GCO
 
@@ -3465,6 +3727,84 @@ Object *PartitionManager::getClosestObjects(
 }
 
 
+//-----------------------------------------------------------------------------
+#ifdef FASTER_GCO
+const PartitionManager::RangeQueryCandidateVec& PartitionManager::getRangeQueryCandidates(
+	Int cellX,
+	Int cellY,
+	Int maxRadius,
+	RangeQueryCacheUser cacheUser
+)
+{
+	DEBUG_ASSERTCRASH(cacheUser >= 0 && cacheUser < RANGE_QUERY_USER_COUNT, ("bad range query cache user %d", cacheUser));
+
+	RangeQueryCacheEntry& entry = m_rangeQueryCache[(UnsignedInt)(cellY * m_cellCountX + cellX) & (RANGE_QUERY_CACHE_SIZE - 1)];
+	if (entry.stamp == m_rangeQueryCacheStamp && entry.cellX == cellX && entry.cellY == cellY && entry.maxRadius >= maxRadius)
+	{
+		++m_rangeQueryCacheHits[cacheUser];
+		return entry.candidates;
+	}
+	++m_rangeQueryCacheMisses[cacheUser];
+
+	Int bucketRadius = ((maxRadius + RANGE_QUERY_RADIUS_BUCKET - 1) / RANGE_QUERY_RADIUS_BUCKET) * RANGE_QUERY_RADIUS_BUCKET;
+	if (bucketRadius > m_maxGcoRadius)
+		bucketRadius = m_maxGcoRadius;
+
+	entry.cellX = cellX;
+	entry.cellY = cellY;
+	entry.maxRadius = bucketRadius;
+	entry.stamp = m_rangeQueryCacheStamp;
+	entry.candidates.clear();
+
+	++theGcoIterFlag;
+
+	// this must visit the cells and objects in the same order as getClosestObjects does.
+	for (Int curRadius = 0; curRadius <= bucketRadius; ++curRadius)
+	{
+		const OffsetVec& offsets = m_radiusVec[curRadius];
+		for (OffsetVec::const_iterator it = offsets.begin(); it != offsets.end(); ++it)
+		{
+			PartitionCell* thisCell = getCellAt(cellX + it->x, cellY + it->y);
+			if (thisCell == NULL)
+				continue;
+
+			for (CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell(); thisCoi; thisCoi = thisCoi->getNextCoi())
+			{
+				PartitionData *thisMod = thisCoi->getModule();
+				Object *thisObj = thisMod->getObject();
+				if (thisObj == NULL)
+					continue;
+
+				if (thisMod->friend_getDoneFlag() == theGcoIterFlag)
+					continue;
+				thisMod->friend_setDoneFlag(theGcoIterFlag);
+
+				RangeQueryCandidate candidate;
+				candidate.obj = thisObj;
+				candidate.radius = curRadius;
+				entry.candidates.push_back(candidate);
+			}
+		}
+	}
+
+	return entry.candidates;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+void PartitionManager::getRangeQueryCacheStats(RangeQueryCacheUser cacheUser, UnsignedInt& hits, UnsignedInt& misses) const
+{
+	hits = 0;
+	misses = 0;
+#ifdef FASTER_GCO
+	if (cacheUser >= 0 && cacheUser < RANGE_QUERY_USER_COUNT)
+	{
+		hits = m_rangeQueryCacheHits[cacheUser];
+		misses = m_rangeQueryCacheMisses[cacheUser];
+	}
+#endif
+}
+
 //-----------------------------------------------------------------------------
 Object *PartitionManager::getClosestObject(
 	const Object *obj,
@@ -3472,10 +3812,11 @@ Object *PartitionManager::getClosestObject(
 	DistanceCalculationType dc,
 	PartitionFilter **filters,
 	Real *closestDist,
-	Coord3D *closestDistVec
+	Coord3D *closestDistVec,
+	RangeQueryCacheUser cacheUser
 )
 {
-	return getClosestObjects(obj, NULL, maxDist, dc, filters, NULL, closestDist, closestDistVec);
+	return getClosestObjects(obj, NULL, maxDist, dc, filters, NULL, closestDist, closestDistVec, cacheUser);
 }
 
 //-----------------------------------------------------------------------------
@@ -3485,10 +3826,11 @@ Object *PartitionManager::getClosestObject(
 	DistanceCalculationType dc,
 	PartitionFilter **filters,
 	Real *closestDist,
-	Coord3D *closestDistVec
+	Coord3D *closestDistVec,
+	RangeQueryCacheUser cacheUser
 )
 {
-	return getClosestObjects(NULL, pos, maxDist, dc, filters, NULL, closestDist, closestDistVec);
+	return getClosestObjects(NULL, pos, maxDist, dc, filters, NULL, closestDist, closestDistVec, cacheUser);
 }
 
 //-----------------------------------------------------------------------------
@@ -3618,14 +3960,15 @@ SimpleObjectIterator *PartitionManager::iterateObjectsInRange(
 	Real maxDist,
 	DistanceCalculationType dc,
 	PartitionFilter **filters,
-	IterOrderType order
+	IterOrderType order,
+	RangeQueryCacheUser cacheUser
 )
 {
 	MemoryPoolObjectHolder iterHolder;
 	SimpleObjectIterator *iter = newInstance(SimpleObjectIterator);
 	iterHolder.hold(iter);
 
-	getClosestObjects(obj, NULL, maxDist, dc, filters, iter, NULL, NULL);
+	getClosestObjects(obj, NULL, maxDist, dc, filters, iter, NULL, NULL, cacheUser);
 
 	iter->sort(order);
 	iterHolder.release();
@@ -3638,14 +3981,15 @@ SimpleObjectIterator *PartitionManager::iterateObjectsInRange(
 	Real maxDist,
 	DistanceCalculationType dc,
 	PartitionFilter **filters,
-	IterOrderType order
+	IterOrderType order,
+	RangeQueryCacheUser cacheUser
 )
 {
 	MemoryPoolObjectHolder iterHolder;
 	SimpleObjectIterator *iter = newInstance(SimpleObjectIterator);
 	iterHolder.hold(iter);
 
-	getClosestObjects(NULL, pos, maxDist, dc, filters, iter, NULL, NULL);
+	getClosestObjects(NULL, pos, maxDist, dc, filters, iter, NULL, NULL, cacheUser);
 
 	iter->sort(order);
 	iterHolder.release();
@@ -208,7 +208,7 @@ void ScriptConditions::objectTypesFromParam(Parameter *pTypeParm, ObjectTypes *o
 		return;
 	}
 
-	ObjectTypes *types = TheScriptEngine->getObjectTypes(str);
+	ObjectTypes *types = TheScriptEngine->getObjectTypesFromParam(pTypeParm);
 	if (!types) {
 		(*outObjectTypes).addObjectType(str);
 	} else {
@@ -246,7 +246,7 @@ Bool ScriptConditions::evaluateAllBuildFacilitiesDestroyed(Parameter *pSideParm
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateIsDestroyed(Parameter *pTeamParm)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	// The team is the team based on the name, and the calling team (if any) and the team that
 	// is being considered for the condition.  jba. :)
 	if (theTeam) {
@@ -396,11 +396,10 @@ Bool ScriptConditions::evaluateHasUnits(Parameter *pTeamParm)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamInsideAreaPartially(Parameter *pTeamParm, Parameter *pTriggerAreaParm, Parameter *pTypeParm)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	// The team is the team based on the name, and the calling team (if any) and the team that
 	// is being considered for the condition.  jba. :)
-	AsciiString triggerName = pTriggerAreaParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerAreaParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerAreaParm);
 
 	if (pTrig == NULL) return false;
 	if (theTeam) {
@@ -421,8 +420,7 @@ Bool ScriptConditions::evaluateNamedInsideArea(Parameter *pUnitParm, Parameter *
 		return false;
 	}
 
-	AsciiString triggerName = pTriggerAreaParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerAreaParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerAreaParm);
 	if (pTrig == NULL) return false;
 	if (theObj) {
 		Coord3D pCoord = *theObj->getPosition();
@@ -438,8 +436,7 @@ Bool ScriptConditions::evaluateNamedInsideArea(Parameter *pUnitParm, Parameter *
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluatePlayerHasUnitTypeInArea(Condition *pCondition, Parameter *pPlayerParm, Parameter *pComparisonParm, Parameter *pCountParm, Parameter *pTypeParm, Parameter *pTriggerParm )
 {
-	AsciiString triggerName = pTriggerParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 	if (pTrig == NULL) return false;
 
 	Player* pPlayer = playerFromParam(pPlayerParm);
@@ -531,8 +528,7 @@ Bool ScriptConditions::evaluatePlayerHasUnitTypeInArea(Condition *pCondition, Pa
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluatePlayerHasUnitKindInArea(Condition *pCondition, Parameter *pPlayerParm, Parameter *pComparisonParm, Parameter *pCountParm, Parameter *pKindParm, Parameter *pTriggerParm )
 {
-	AsciiString triggerName = pTriggerParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 	if (pTrig == NULL) return false;
 
 	KindOfType kind = (KindOfType)pKindParm->getInt();
@@ -612,7 +608,7 @@ Bool ScriptConditions::evaluatePlayerHasUnitKindInArea(Condition *pCondition, Pa
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamStateIs(Parameter *pTeamParm, Parameter *pStateParm )
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	// The team is the team based on the name, and the calling team (if any) and the team that
 	// is being considered for the condition.  jba. :)
 	AsciiString stateName = pStateParm->getString();
@@ -628,7 +624,7 @@ Bool ScriptConditions::evaluateTeamStateIs(Parameter *pTeamParm, Parameter *pSta
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamStateIsNot(Parameter *pTeamParm, Parameter *pStateParm )
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	// The team is the team based on the name, and the calling team (if any) and the team that
 	// is being considered for the condition.  jba. :)
 	AsciiString stateName = pStateParm->getString();
@@ -652,11 +648,10 @@ Bool ScriptConditions::evaluateNamedOutsideArea(Parameter *pUnitParm, Parameter
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamInsideAreaEntirely(Parameter *pTeamParm, Parameter *pTriggerParm, Parameter *pTypeParm)
 {// This is actually TeamInside(...)
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	// The team is the team based on the name, and the calling team (if any) and the team that
 	// is being considered for the condition.  jba. :)
-	AsciiString triggerName = pTriggerParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (pTrig == NULL)
 		return false;
@@ -733,7 +728,7 @@ Bool ScriptConditions::evaluateNamedAttackedByType(Parameter *pUnitParm, Paramet
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamAttackedByType(Parameter *pTeamParm, Parameter *pTypeParm)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!theTeam) {
 		return FALSE;
 	}
@@ -835,7 +830,7 @@ Bool ScriptConditions::evaluateNamedAttackedByPlayer(Parameter *pUnitParm, Param
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamAttackedByPlayer(Parameter *pTeamParm, Parameter *pPlayerParm)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!theTeam) {
 		return false;
 	}
@@ -930,7 +925,7 @@ Bool ScriptConditions::evaluateNamedCreated(Parameter* pUnitParm)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamCreated(Parameter* pTeamParm)
 {
-	Team *pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team *pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (pTeam) {
 		return pTeam->isCreated();
 	}
@@ -1186,7 +1181,7 @@ Bool ScriptConditions::evaluateNamedDiscovered(Parameter *pItemParm, Parameter*
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamDiscovered(Parameter *pTeamParm, Parameter *pPlayerParm)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!theTeam) {
 		return false;
 	}
@@ -1263,7 +1258,7 @@ Bool ScriptConditions::evaluateTeamOwnedByPlayer(Parameter *pTeamParm, Parameter
 		return false;
 	}
 
-	Team* pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team* pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!pTeam) {
 		return false;
 	}
@@ -1350,7 +1345,7 @@ Bool ScriptConditions::evaluateNamedReachedWaypointsEnd(Parameter *pUnitParm, Pa
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamReachedWaypointsEnd(Parameter *pTeamParm, Parameter* pWaypointPathParm)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!theTeam) {
 		return false;
 	}
@@ -1645,7 +1640,7 @@ Bool ScriptConditions::evaluateNamedEnteredArea(Parameter *pUnitParm, Parameter
 		return false;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (!pTrig) {
 		return false;
@@ -1664,7 +1659,7 @@ Bool ScriptConditions::evaluateNamedExitedArea(Parameter *pUnitParm, Parameter *
 		return false;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (!pTrig) {
 		return false;
@@ -1678,12 +1673,12 @@ Bool ScriptConditions::evaluateNamedExitedArea(Parameter *pUnitParm, Parameter *
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamEnteredAreaEntirely(Parameter *pTeamParm, Parameter *pTriggerParm, Parameter *pTypeParm)
 {
-	Team* pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team* pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!pTeam) {
 		return false;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (pTrig) {
 		return pTeam->didAllEnter(pTrig, (UnsignedInt)pTypeParm->getInt());
@@ -1697,12 +1692,12 @@ Bool ScriptConditions::evaluateTeamEnteredAreaEntirely(Parameter *pTeamParm, Par
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamEnteredAreaPartially(Parameter *pTeamParm, Parameter *pTriggerParm, Parameter *pTypeParm)
 {
-	Team* pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team* pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!pTeam) {
 		return false;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (pTrig) {
 		return pTeam->didPartialEnter(pTrig, (UnsignedInt)pTypeParm->getInt());
@@ -1716,12 +1711,12 @@ Bool ScriptConditions::evaluateTeamEnteredAreaPartially(Parameter *pTeamParm, Pa
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamExitedAreaEntirely(Parameter *pTeamParm, Parameter *pTriggerParm, Parameter *pTypeParm)
 {
-	Team* pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team* pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!pTeam) {
 		return false;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (!pTrig) {
 		return false;
@@ -1735,12 +1730,12 @@ Bool ScriptConditions::evaluateTeamExitedAreaEntirely(Parameter *pTeamParm, Para
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamExitedAreaPartially(Parameter *pTeamParm, Parameter *pTriggerParm, Parameter *pTypeParm)
 {
-	Team* pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team* pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!pTeam) {
 		return false;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (!pTrig) {
 		return false;
@@ -2016,7 +2011,7 @@ Bool ScriptConditions::evaluateUnitHasEmptied(Parameter *pUnitParm)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamIsContained(Parameter *pTeamParm, Bool allContained)
 {
-	Team* pTeam = TheScriptEngine->getTeamNamed(pTeamParm->getString());
+	Team* pTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!pTeam) {
 		return false;
 	}
@@ -2072,7 +2067,7 @@ Bool ScriptConditions::evaluateUnitHasObjectStatus(Parameter *pUnitParm, Paramet
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateTeamHasObjectStatus(Parameter *pTeamParm, Parameter *pObjectStatus, Bool entireTeam)
 {
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!theTeam) {
 		return false;
 	}
@@ -2115,8 +2110,7 @@ Bool ScriptConditions::evaluateSkirmishValueInArea(Condition *pCondition, Parame
 		return false;
 	}
 
-	AsciiString triggerName = pTriggerParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 
 	if (!pTrig) {
 		return false;
@@ -2212,7 +2206,7 @@ Bool ScriptConditions::evaluateSkirmishSuppliesWithinDistancePerimeter(Parameter
 		return false;
 	}
 
-	PolygonTrigger *trigger = TheScriptEngine->getQualifiedTriggerAreaByName(pLocationParm->getString());
+	PolygonTrigger *trigger = TheScriptEngine->getQualifiedTriggerAreaFromParam(pLocationParm);
 	if (!trigger) {
 		return false;
 	}
@@ -2263,7 +2257,7 @@ Bool ScriptConditions::evaluateSkirmishPlayerTechBuildingWithinDistancePerimeter
 	if (pCondition->getCustomData()==1) return true;
 	if (pCondition->getCustomData()==-1) return false;
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pLocationParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pLocationParm);
 	if (!pTrig) {
 		return false;
 	}
@@ -2292,7 +2286,7 @@ Bool ScriptConditions::evaluateSkirmishPlayerTechBuildingWithinDistancePerimeter
 Bool ScriptConditions::evaluateSkirmishCommandButtonIsReady( Parameter * /* pSkirmishPlayerParm */, Parameter *pTeamParm, Parameter *pCommandButtonParm, Bool allReady )
 {
 	// In this one case, the pSkirmishPlayerParm isn't used.
-	Team *theTeam = TheScriptEngine->getTeamNamed( pTeamParm->getString() );
+	Team *theTeam = TheScriptEngine->getTeamFromParam(pTeamParm);
 	if (!theTeam) {
 		return false;
 	}
@@ -2487,15 +2481,14 @@ Bool ScriptConditions::evaluateSkirmishPlayerHasComparisonCapturedUnits(Paramete
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateSkirmishNamedAreaExists(Parameter *, Parameter *pTriggerParm)
 {
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 	return (pTrig != NULL);
 }
 
 //-------------------------------------------------------------------------------------------------
 Bool ScriptConditions::evaluateSkirmishPlayerHasUnitsInArea(Condition *pCondition, Parameter *pSkirmishPlayerParm, Parameter *pTriggerParm )
 {
-	AsciiString triggerName = pTriggerParm->getString();
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 	if (pTrig == NULL) return false;
 
 	Player* pPlayer = playerFromParam(pSkirmishPlayerParm);
@@ -2635,7 +2628,7 @@ Bool ScriptConditions::evaluateSkirmishPlayerIsOutsideArea(Condition *pCondition
 		return FALSE;
 	}
 
-	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaByName(pTriggerParm->getString());
+	PolygonTrigger *pTrig = TheScriptEngine->getQualifiedTriggerAreaFromParam(pTriggerParm);
 	if (!pTrig) {
 		return FALSE;
 	}
@@ -55,6 +55,7 @@
 #include "GameLogic/ScriptActions.h"
 #include "GameLogic/ScriptConditions.h"
 #include "GameLogic/ScriptEngine.h"
+#include "GameLogic/ScriptProfiler.h"
 #include "GameLogic/SidesList.h"
 
 
@@ -5306,6 +5307,8 @@ void ScriptEngine::reset( void )
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
 	}
+	m_counterIndex.clear();
+	m_flagIndex.clear();
 
 	m_breezeInfo.m_direction = PI/3;
 	m_breezeInfo.m_directionVec.x = Sin(m_breezeInfo.m_direction);
@@ -5397,11 +5400,15 @@ void ScriptEngine::reset( void )
 	}
 	DEBUG_ASSERTCRASH( m_allObjectTypeLists.empty() == TRUE, ("ScriptEngine::reset - m_allObjectTypeLists should be empty but is not!") );
 
+	// The script parameters of the old map must not keep pointers into it.
+	Parameter::invalidateBoundHandles();
+
 	// reset all the reveals that have taken place.
 	m_namedReveals.clear();
 
 	// Clear the named objects list.
  	m_namedObjects.clear();
+	m_namedObjectIndex.clear();
 
 	m_completedVideo.clear();
 	m_testingSpeech.clear();
@@ -5448,8 +5455,11 @@ void ScriptEngine::newMap( void )
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
 	}
+	m_counterIndex.clear();
+	m_flagIndex.clear();
 	m_endGameTimer = -1;
 	m_closeWindowTimer = -1;
+	Parameter::invalidateBoundHandles();
 #ifdef SPECIAL_SCRIPT_PROFILING
 #ifdef DEBUG_LOGGING
 	m_numFrames=0;
@@ -5579,6 +5589,9 @@ void ScriptEngine::update( void )
 		}
 	}
 
+	if (TheScriptProfiler)
+		TheScriptProfiler->beginFrame();
+
 	// Evaluate the scripts.
 	for (i=0; i<TheSidesList->getNumSides(); i++) {
 		m_currentPlayer = ThePlayerList->getNthPlayer(i);
@@ -5776,11 +5789,9 @@ void ScriptEngine::clearFlag(const AsciiString &name)
 		AsciiString modName;
 		modName.format("%s%d", name.str(), j);
 		// Note - flags start at 1.  0 means not assigned.
-		Int i;
-		for (i=1; i<m_numFlags; i++) {
-			if ((modName==m_flags[i].name)) {
-				m_flags[i].value = FALSE;
-			}
+		NameKeyIndexMap::const_iterator it = m_flagIndex.find(NAMEKEY(modName));
+		if (it != m_flagIndex.end()) {
+			m_flags[it->second].value = FALSE;
 		}
 	}
 }  // end clearFlag
@@ -5879,6 +5890,19 @@ ObjectTypes *ScriptEngine::getObjectTypes(const AsciiString& objectTypeList)
 	return NULL;
 }
 
+//-------------------------------------------------------------------------------------------------
+/** getObjectTypesFromParam */
+//-------------------------------------------------------------------------------------------------
+ObjectTypes *ScriptEngine::getObjectTypesFromParam(Parameter *pTypeParm)
+{
+	void *handle;
+	if (!pTypeParm->friend_getBoundHandle(&handle)) {
+		handle = getObjectTypes(pTypeParm->getString());
+		pTypeParm->friend_setBoundHandle(handle);
+	}
+	return (ObjectTypes *)handle;
+}
+
 //-------------------------------------------------------------------------------------------------
 /** doObjectTypeListMaintenance */
 /** If addObject is false, remove the object. If it is true, add the object. */
@@ -5891,6 +5915,7 @@ void ScriptEngine::doObjectTypeListMaintenance(const AsciiString& objectTypeList
 	if (!currentObjectTypeVec) {
 		ObjectTypes *newVec = newInstance(ObjectTypes)(objectTypeList);
 		m_allObjectTypeLists.push_back(newVec);
+		Parameter::invalidateBoundHandles();
 		currentObjectTypeVec = newVec;
 	}
 
@@ -5953,30 +5978,92 @@ PolygonTrigger *ScriptEngine::getQualifiedTriggerAreaByName( AsciiString name )
 	return trig;
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Same as getQualifiedTriggerAreaByName, but keeps the trigger area in the parameter so that the
+trigger list is only searched again after trigger areas were added or removed. The perimeter names
+depend on the current player and are always qualified again. */
+//-------------------------------------------------------------------------------------------------
+PolygonTrigger *ScriptEngine::getQualifiedTriggerAreaFromParam( Parameter *pTriggerParm )
+{
+	const AsciiString& name = pTriggerParm->getString();
+	if (name == MY_INNER_PERIMETER || name == MY_OUTER_PERIMETER ||
+			name == ENEMY_INNER_PERIMETER || name == ENEMY_OUTER_PERIMETER) {
+		return getQualifiedTriggerAreaByName(name);
+	}
 
+	void *handle;
+	if (!pTriggerParm->friend_getBoundHandle(&handle)) {
+		// Resolves and warns on first use.
+		handle = getQualifiedTriggerAreaByName(name);
+		pTriggerParm->friend_setBoundHandle(handle);
+	}
+	return (PolygonTrigger *)handle;
+}
 
 //-------------------------------------------------------------------------------------------------
-/** getTeamNamed */
+/** Resolves the team names that do not name a team prototype. Returns true if teamName is one. */
 //-------------------------------------------------------------------------------------------------
-Team * ScriptEngine::getTeamNamed(const AsciiString& teamName)
+Bool ScriptEngine::getTeamAlias( const AsciiString& teamName, Team **team )
 {
 	Bool is_GeneralsChallengeContext = TheCampaignManager->getCurrentCampaign() && TheCampaignManager->getCurrentCampaign()->m_isChallengeCampaign;
-	if (teamName == TEAM_THE_PLAYER && is_GeneralsChallengeContext)
+	if (teamName == TEAM_THE_PLAYER && is_GeneralsChallengeContext) {
 		// Designers have built their Generals' Challenge maps, referencing "teamThePlayer" meaning the local player's default (parent) team.
 		// However, they've also built many of their single player maps with this string, where "teamThePlayer" is not intended as an alias.
-		return ThePlayerList->getLocalPlayer()->getDefaultTeam();
+		*team = ThePlayerList->getLocalPlayer()->getDefaultTeam();
+		return TRUE;
+	}
 	if (teamName == THIS_TEAM) {
-		if (m_callingTeam)
-			return m_callingTeam;
-		return m_conditionTeam;
+		*team = m_callingTeam ? m_callingTeam : m_conditionTeam;
+		return TRUE;
 	}
 	if (m_callingTeam && m_callingTeam->getName() == teamName) {
-		return m_callingTeam;
+		*team = m_callingTeam;
+		return TRUE;
 	}
 	if (m_conditionTeam && m_conditionTeam->getName() == teamName) {
-		return m_conditionTeam;
+		*team = m_conditionTeam;
+		return TRUE;
 	}
-	TeamPrototype *theTeamProto = TheTeamFactory->findTeamPrototype( teamName );
+	return FALSE;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** getTeamNamed */
+//-------------------------------------------------------------------------------------------------
+Team * ScriptEngine::getTeamNamed(const AsciiString& teamName)
+{
+	Team *theTeam;
+	if (getTeamAlias(teamName, &theTeam)) {
+		return theTeam;
+	}
+	return getTeamFromPrototype(TheTeamFactory->findTeamPrototype( teamName ), teamName);
+}  // end getTeamNamed
+
+//-------------------------------------------------------------------------------------------------
+/** Same as getTeamNamed, but keeps the team prototype in the parameter so that the team factory
+is only searched again after team prototypes were added or removed. */
+//-------------------------------------------------------------------------------------------------
+Team *ScriptEngine::getTeamFromParam(Parameter *pTeamParm)
+{
+	const AsciiString& teamName = pTeamParm->getString();
+	Team *theTeam;
+	if (getTeamAlias(teamName, &theTeam)) {
+		return theTeam;
+	}
+
+	void *handle;
+	if (!pTeamParm->friend_getBoundHandle(&handle)) {
+		handle = TheTeamFactory->findTeamPrototype( teamName );
+		pTeamParm->friend_setBoundHandle(handle);
+	}
+	return getTeamFromPrototype((TeamPrototype *)handle, teamName);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** getTeamFromPrototype */
+//-------------------------------------------------------------------------------------------------
+Team *ScriptEngine::getTeamFromPrototype( TeamPrototype *theTeamProto, const AsciiString& teamName )
+{
 	if (theTeamProto == NULL) return NULL;
 	if (theTeamProto->getIsSingleton()) {
 		Team *theTeam = theTeamProto->getFirstItemIn_TeamInstanceList();
@@ -5995,7 +6082,7 @@ Team * ScriptEngine::getTeamNamed(const AsciiString& teamName)
 		}
 	}
 	return theTeamProto->getFirstItemIn_TeamInstanceList();
-}  // end getTeamNamed
+}
 
 //-------------------------------------------------------------------------------------------------
 /** getUnitNamed */
@@ -6009,10 +6096,9 @@ Object * ScriptEngine::getUnitNamed(const AsciiString& unitName)
 		return m_conditionObject;
 	}
 
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (unitName == (it->first)) {
-			return it->second;
-		}
+	Int ndx = findNamedObjectIndex(unitName);
+	if (ndx >= 0) {
+		return m_namedObjects[ndx].second;
 	}
 	return NULL;
 }
@@ -6022,10 +6108,9 @@ Object * ScriptEngine::getUnitNamed(const AsciiString& unitName)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptEngine::didUnitExist(const AsciiString& unitName)
 {
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (unitName == (it->first)) {
-			return (it->second == NULL);
-		}
+	Int ndx = findNamedObjectIndex(unitName);
+	if (ndx >= 0) {
+		return (m_namedObjects[ndx].second == NULL);
 	}
 	return false;
 }
@@ -6138,16 +6223,17 @@ Int ScriptEngine::allocateCounter( const AsciiString& name)
 {
 	Int i;
 	// Note - counters start at 1.  0 means not assigned.
-	for (i=1; i<m_numCounters; i++) {
-		if (name==m_counters[i].name) {
-			return i;
-		}
+	NameKeyType key = NAMEKEY(name);
+	NameKeyIndexMap::const_iterator it = m_counterIndex.find(key);
+	if (it != m_counterIndex.end()) {
+		return it->second;
 	}
 	DEBUG_ASSERTCRASH(m_numCounters<MAX_COUNTERS, ("Too many counters, failed to make '%s'.", name.str()));
 	if (m_numCounters < MAX_COUNTERS) {
 		m_counters[m_numCounters].name = name;
 		i = m_numCounters;
 		m_numCounters++;
+		m_counterIndex[key] = i;
 		return(i);
 	}
 	return 0; // Shouldn't ever happen.
@@ -6158,13 +6244,10 @@ Int ScriptEngine::allocateCounter( const AsciiString& name)
 //-------------------------------------------------------------------------------------------------
 const TCounter *ScriptEngine::getCounter(const AsciiString& counterName)
 {
-	Int i;
-	for (i=1; i<m_numCounters; i++)
+	NameKeyIndexMap::const_iterator it = m_counterIndex.find(NAMEKEY(counterName));
+	if (it != m_counterIndex.end())
 	{
-		if (counterName == m_counters[i].name)
-		{
-			return &(m_counters[i]);
-		}
+		return &(m_counters[it->second]);
 	}
 	return NULL;
 }
@@ -6276,16 +6359,17 @@ Int ScriptEngine::allocateFlag( const AsciiString& name)
 {
 	Int i;
 	// Note - flags start at 1.  0 means not assigned.
-	for (i=1; i<m_numFlags; i++) {
-		if ((name==m_flags[i].name)) {
-			return i;
-		}
+	NameKeyType key = NAMEKEY(name);
+	NameKeyIndexMap::const_iterator it = m_flagIndex.find(key);
+	if (it != m_flagIndex.end()) {
+		return it->second;
 	}
 	DEBUG_ASSERTCRASH(m_numFlags < MAX_FLAGS, ("Too many flags, failed to make '%s'..", name.str()));
 	if (m_numFlags < MAX_FLAGS) {
 		m_flags[m_numFlags].name = name;
 		i = m_numFlags;
 		m_numFlags++;
+		m_flagIndex[key] = i;
 		return(i);
 	}
 	return 0; // Shouldn't ever happen.
@@ -6714,6 +6798,7 @@ void ScriptEngine::removeObjectTypes(ObjectTypes *typesToRemove)
 
 	// remove it from the main array of stuff
 	m_allObjectTypeLists.erase(it);
+	Parameter::invalidateBoundHandles();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6978,6 +7063,7 @@ void ScriptEngine::executeScript( Script *pScript )
 	if (delaySeconds>0) {
 		pScript->setFrameToEvaluate(TheGameLogic->getFrame()+delaySeconds*LOGICFRAMES_PER_SECOND);
 	}
+	const Int64 profileStartTicks = TheScriptProfiler ? LogicProfiler::getTicks() : 0;
 #ifdef DEBUG_LOGGING
 #ifdef SPECIAL_SCRIPT_PROFILING
 	__int64 startTime64;
@@ -7055,6 +7141,9 @@ void ScriptEngine::executeScript( Script *pScript )
 #endif
 
 	m_conditionTeam = pSavConditionTeam;
+
+	if (TheScriptProfiler)
+		TheScriptProfiler->addScriptTime(pScript, LogicProfiler::getTicks() - profileStartTicks);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7062,15 +7151,20 @@ void ScriptEngine::executeScript( Script *pScript )
 //-------------------------------------------------------------------------------------------------
 Bool ScriptEngine::evaluateCondition( Condition *pCondition )
 {
+	const Int64 startTicks = TheScriptProfiler ? LogicProfiler::getTicks() : 0;
+	Bool result;
 	switch (pCondition->getConditionType()) {
 		default:
-			return TheScriptConditions->evaluateCondition(pCondition);
-		case Condition::CONDITION_FALSE: return false;
-		case Condition::CONDITION_TRUE: return true;
-		case Condition::COUNTER: return evaluateCounter(pCondition);
-		case Condition::FLAG: return evaluateFlag(pCondition);
-		case Condition::TIMER_EXPIRED: return evaluateTimer(pCondition);
+			result = TheScriptConditions->evaluateCondition(pCondition); break;
+		case Condition::CONDITION_FALSE: result = false; break;
+		case Condition::CONDITION_TRUE: result = true; break;
+		case Condition::COUNTER: result = evaluateCounter(pCondition); break;
+		case Condition::FLAG: result = evaluateFlag(pCondition); break;
+		case Condition::TIMER_EXPIRED: result = evaluateTimer(pCondition); break;
 	}
+	if (TheScriptProfiler)
+		TheScriptProfiler->addConditionTime(pCondition->getConditionType(), LogicProfiler::getTicks() - startTicks);
+	return result;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7125,6 +7219,7 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 
 		if (pNewObject == (it->second)) {
 			it->first = objName;
+			rebuildNamedObjectIndex();
 			return;
 		}
 	}
@@ -7134,6 +7229,7 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 	req.second = pNewObject;
 
 	m_namedObjects.push_back(req);
+	m_namedObjectIndex.insert(std::make_pair(NAMEKEY(objName), (Int)m_namedObjects.size() - 1));
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7141,6 +7237,13 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 //-------------------------------------------------------------------------------------------------
 void ScriptEngine::removeObjectFromCache( Object* pDeadObject )
 {
+	// The object is usually cached under its own name, so try that entry first.
+	Int ndx = findNamedObjectIndex(pDeadObject->getName());
+	if (ndx >= 0 && m_namedObjects[ndx].second == pDeadObject) {
+		m_namedObjects[ndx].second = NULL;	// Don't remove it, cause we want to check whether we ever knew a name later
+		return;
+	}
+
 	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
 		if (pDeadObject == (it->second)) {
 			it->second = NULL;	// Don't remove it, cause we want to check whether we ever knew a name later
@@ -7174,26 +7277,23 @@ void ScriptEngine::transferObjectName( const AsciiString& unitName, Object *pNew
 
 	pNewObject->setName(unitName); // make sure it's named the name.
 
-	//Loop through the cached list and find the string entry. If found, change the object
+	//Find the string entry in the cached list. If found, change the object
 	//so it's pointing to the new one.
-	for( VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it )
+	Int ndx = findNamedObjectIndex(unitName);
+	if( ndx >= 0 )
 	{
-		if( !unitName.compare( it->first ) )
+		NamedRequest &req = m_namedObjects[ndx];
+		Object* pOldObj = req.second;
+		if( pOldObj )
 		{
-			Object* pOldObj = it->second;
-			if( pOldObj )
-			{
-				// if you are transferring your name, you should also transfer any custom indicator color you have.
-				if (pOldObj->hasCustomIndicatorColor())
-					pNewObject->setCustomIndicatorColor(pOldObj->getIndicatorColor());
-				else
-					pNewObject->removeCustomIndicatorColor();
-			}
-
-			it->second = pNewObject;
-
-			return;
+			// if you are transferring your name, you should also transfer any custom indicator color you have.
+			if (pOldObj->hasCustomIndicatorColor())
+				pNewObject->setCustomIndicatorColor(pOldObj->getIndicatorColor());
+			else
+				pNewObject->removeCustomIndicatorColor();
 		}
+
+		req.second = pNewObject;
 	}
 
 }
@@ -7591,6 +7691,7 @@ Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *
 	LatchRestore<Player*> latch2(m_currentPlayer, player);
 	OrCondition *pConditionHead = pScript->getOrCondition();
 	Bool testValue = false;
+	const Int64 profileStartTicks = TheScriptProfiler ? LogicProfiler::getTicks() : 0;
 
 #ifdef DEBUG_LOGGING
 #define COLLECT_CONDITION_EVAL_TIMES
@@ -7625,6 +7726,8 @@ Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *
 	pScript->incrementConditionCount();
 	pScript->addToConditionTime(timeToEvaluate);
 #endif
+	if (TheScriptProfiler)
+		TheScriptProfiler->addScriptConditionTime(pScript, LogicProfiler::getTicks() - profileStartTicks);
 
 	return testValue; // If none of the or's fired, then it is false.
 }
@@ -7639,6 +7742,7 @@ void ScriptEngine::executeActions( ScriptAction *pActionHead )
 	ScriptAction *pCurAction;
 	UnicodeString uStr1;
 	for (pCurAction = pActionHead; pCurAction; pCurAction = pCurAction->getNext()) {
+		const Int64 profileStartTicks = TheScriptProfiler ? LogicProfiler::getTicks() : 0;
 		switch (pCurAction->getActionType()) {
 			default: if (TheScriptActions) TheScriptActions->executeAction(pCurAction); break;
 			case ScriptAction::SET_COUNTER: setCounter(pCurAction);	break;
@@ -7672,6 +7776,8 @@ void ScriptEngine::executeActions( ScriptAction *pActionHead )
 
 			case ScriptAction::NO_OP: /* just break. */; break;
 		}
+		if (TheScriptProfiler)
+			TheScriptProfiler->addActionTime(pCurAction->getActionType(), LogicProfiler::getTicks() - profileStartTicks);
 	}
 }
 
@@ -7737,6 +7843,51 @@ void ScriptEngine::createNamedCache( void )
 		}
 		pObj = pObj->getNextObject();
 	}
+	rebuildNamedObjectIndex();
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Returns the index of the first named object cache entry with this name, or -1. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::findNamedObjectIndex( const AsciiString& unitName ) const
+{
+	if (unitName.isEmpty()) {
+		return -1;
+	}
+	NameKeyIndexMap::const_iterator it = m_namedObjectIndex.find(NAMEKEY(unitName));
+	if (it == m_namedObjectIndex.end()) {
+		return -1;
+	}
+	return it->second;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Rebuilds the name index of the named object cache. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::rebuildNamedObjectIndex( void )
+{
+	m_namedObjectIndex.clear();
+	for (Int i = 0; i < (Int)m_namedObjects.size(); ++i) {
+		// insert keeps the first entry of a name, which is the one the old linear search found.
+		m_namedObjectIndex.insert(std::make_pair(NAMEKEY(m_namedObjects[i].first), i));
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Rebuilds the name indices of the counters and flags. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::rebuildCounterAndFlagIndex( void )
+{
+	Int i;
+	m_counterIndex.clear();
+	// Note - counters and flags start at 1.  0 means not assigned.
+	for (i = 1; i < m_numCounters; ++i) {
+		m_counterIndex.insert(std::make_pair(NAMEKEY(m_counters[i].name), i));
+	}
+	m_flagIndex.clear();
+	for (i = 1; i < m_numFlags; ++i) {
+		m_flagIndex.insert(std::make_pair(NAMEKEY(m_flags[i].name), i));
+	}
 }
 
 void ScriptEngine::appendSequentialScript(const SequentialScript *scriptToSequence)
@@ -8956,6 +9107,9 @@ void ScriptEngine::xfer( Xfer *xfer )
 	// num flags
 	xfer->xferInt( &m_numFlags );
 
+	if( xfer->getXferMode() == XFER_LOAD )
+		rebuildCounterAndFlagIndex();
+
 	// attack priority info
 	UnsignedShort attackPriorityInfoSize = m_numAttackInfo;
 	xfer->xferUnsignedShort( &attackPriorityInfoSize );
@@ -9042,6 +9196,8 @@ void ScriptEngine::xfer( Xfer *xfer )
 
 		}  // end for, i
 
+		rebuildNamedObjectIndex();
+
 	}  // end else, load
 
 	// first update
@@ -9286,6 +9442,8 @@ void ScriptEngine::xfer( Xfer *xfer )
 
 			}  // end for, i
 
+			Parameter::invalidateBoundHandles();
+
 		}  //  end else, load
 
 	}  // end if, version 2
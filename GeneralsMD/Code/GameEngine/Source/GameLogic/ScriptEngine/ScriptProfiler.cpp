@@ -0,0 +1,188 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ScriptProfiler.cpp
+// Timings of the individual scripts and of the script condition and action types
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "GameLogic/ScriptEngine.h"
+#include "GameLogic/ScriptProfiler.h"
+
+ScriptProfiler *TheScriptProfiler = NULL;
+
+//-------------------------------------------------------------------------------------------------
+ScriptProfiler::ScriptProfiler() :
+	m_file(NULL),
+	m_frames(0)
+{
+	Int64 ticksPerSecond;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&ticksPerSecond);
+	m_microsecondsPerTick = 1000000.0 / (double)ticksPerSecond;
+}
+
+//-------------------------------------------------------------------------------------------------
+ScriptProfiler::~ScriptProfiler()
+{
+	report();
+
+	if (m_file != NULL)
+	{
+		fclose(m_file);
+		m_file = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool ScriptProfiler::init( const AsciiString& filename )
+{
+	m_file = fopen(filename.str(), "w");
+	if (m_file == NULL)
+		return FALSE;
+
+	fprintf(m_file, "kind,name,calls,microseconds,max_microseconds\n");
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+ScriptProfiler::ScriptTiming& ScriptProfiler::getScriptTiming( const Script *script )
+{
+	ScriptIndexMap::const_iterator it = m_scriptIndex.find(script);
+	if (it != m_scriptIndex.end())
+		return m_scripts[it->second];
+
+	// Keep the name, the script may be gone by the time of the report.
+	m_scriptIndex[script] = (Int)m_scripts.size();
+	m_scripts.push_back(ScriptTiming());
+	m_scripts.back().name = script->getName();
+	return m_scripts.back();
+}
+
+//-------------------------------------------------------------------------------------------------
+void ScriptProfiler::addScriptTime( const Script *script, Int64 ticks )
+{
+	addTime(getScriptTiming(script).total, ticks);
+}
+
+//-------------------------------------------------------------------------------------------------
+void ScriptProfiler::addScriptConditionTime( const Script *script, Int64 ticks )
+{
+	addTime(getScriptTiming(script).conditions, ticks);
+}
+
+//-------------------------------------------------------------------------------------------------
+void ScriptProfiler::writeTiming( const char *kind, const char *name, const Timing& timing )
+{
+	if (m_file != NULL && timing.calls != 0)
+	{
+		fprintf(m_file, "%s,%s,%d,%.1f,%.1f\n",
+			kind, name, timing.calls, ticksToMicroseconds(timing.ticks), ticksToMicroseconds(timing.maxTicks));
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+static bool compareTotalTicks( const std::pair<Int64, Int>& a, const std::pair<Int64, Int>& b )
+{
+	return a.first > b.first;
+}
+
+//-------------------------------------------------------------------------------------------------
+void ScriptProfiler::report( void )
+{
+	if (m_scripts.empty())
+		return;
+
+	Int i;
+	size_t j;
+
+	std::vector< std::pair<Int64, Int> > scripts;
+	scripts.reserve(m_scripts.size());
+	for (j = 0; j < m_scripts.size(); ++j)
+		scripts.push_back(std::make_pair(getReportedTiming(m_scripts[j]).ticks, (Int)j));
+	std::sort(scripts.begin(), scripts.end(), compareTotalTicks);
+
+	std::vector< std::pair<Int64, Int> > conditions;
+	for (i = 0; i < Condition::NUM_ITEMS; ++i)
+	{
+		if (m_conditions[i].calls != 0)
+			conditions.push_back(std::make_pair(m_conditions[i].ticks, i));
+	}
+	std::sort(conditions.begin(), conditions.end(), compareTotalTicks);
+
+	std::vector< std::pair<Int64, Int> > actions;
+	for (i = 0; i < ScriptAction::NUM_ITEMS; ++i)
+	{
+		if (m_actions[i].calls != 0)
+			actions.push_back(std::make_pair(m_actions[i].ticks, i));
+	}
+	std::sort(actions.begin(), actions.end(), compareTotalTicks);
+
+	// The file gets everything, sorted by total time within each kind.
+	for (j = 0; j < scripts.size(); ++j)
+	{
+		const ScriptTiming& timing = m_scripts[scripts[j].second];
+		writeTiming("script", timing.name.str(), timing.total);
+		writeTiming("script_conditions", timing.name.str(), timing.conditions);
+	}
+	for (j = 0; j < conditions.size(); ++j)
+		writeTiming("condition", TheScriptEngine->getConditionTemplate(conditions[j].second)->m_internalName.str(), m_conditions[conditions[j].second]);
+	for (j = 0; j < actions.size(); ++j)
+		writeTiming("action", TheScriptEngine->getActionTemplate(actions[j].second)->m_internalName.str(), m_actions[actions[j].second]);
+	if (m_file != NULL)
+		fflush(m_file);
+
+	// Note that we use printf here because this is run from cmd.
+	const UnsignedInt frames = m_frames > 0 ? m_frames : 1;
+	printf("Script profile over %u script engine updates:\n", m_frames);
+
+	const size_t MAX_REPORTED_SCRIPTS = 20;
+	for (j = 0; j < scripts.size() && j < MAX_REPORTED_SCRIPTS; ++j)
+	{
+		const ScriptTiming& timing = m_scripts[scripts[j].second];
+		const Timing& total = getReportedTiming(timing);
+		printf("   %-40s %10.1f ms %8.3f ms/update %8.3f ms max %10d calls\n",
+			timing.name.str(), ticksToMicroseconds(total.ticks) / 1000.0,
+			ticksToMicroseconds(total.ticks) / 1000.0 / frames,
+			ticksToMicroseconds(total.maxTicks) / 1000.0, total.calls);
+	}
+
+	const size_t MAX_REPORTED_TYPES = 10;
+	for (j = 0; j < conditions.size() && j < MAX_REPORTED_TYPES; ++j)
+	{
+		const Timing& timing = m_conditions[conditions[j].second];
+		printf("   condition %-30s %10.1f ms %10d calls\n",
+			TheScriptEngine->getConditionTemplate(conditions[j].second)->m_internalName.str(),
+			ticksToMicroseconds(timing.ticks) / 1000.0, timing.calls);
+	}
+	for (j = 0; j < actions.size() && j < MAX_REPORTED_TYPES; ++j)
+	{
+		const Timing& timing = m_actions[actions[j].second];
+		printf("   action %-33s %10.1f ms %10d calls\n",
+			TheScriptEngine->getActionTemplate(actions[j].second)->m_internalName.str(),
+			ticksToMicroseconds(timing.ticks) / 1000.0, timing.calls);
+	}
+	fflush(stdout);
+
+	m_scriptIndex.clear();
+	m_scripts.clear();
+	for (i = 0; i < Condition::NUM_ITEMS; ++i)
+		m_conditions[i] = Timing();
+	for (i = 0; i < ScriptAction::NUM_ITEMS; ++i)
+		m_actions[i] = Timing();
+	m_frames = 0;
+}
@@ -1819,6 +1819,7 @@ void Parameter::setCoord3D(const Coord3D *pLoc)
 void Parameter::qualify(const AsciiString& qualifier,
 			const AsciiString& playerTemplateName, const AsciiString& newPlayerName)
 {
+	m_boundHandleGeneration = 0;
 	AsciiString tmpString;
 	switch (m_paramType) {
 		case SIDE:
@@ -2127,6 +2128,9 @@ void Parameter::WriteParameter(DataChunkOutput &chunkWriter)
 	}
 }
 
+// Starts above the generation of new parameters, so that they are not bound.
+UnsignedInt Parameter::s_boundHandleGeneration = 1;
+
 /**
 * Parameter::ReadParameter - read a parameter.
 * Format is the newer CHUNKY format.
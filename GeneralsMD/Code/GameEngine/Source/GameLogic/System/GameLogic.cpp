@@ -58,6 +58,7 @@
 #include "Common/Xfer.h"
 #include "Common/XferCRC.h"
 #include "Common/XferDeepCRC.h"
+#include "Common/XferSave.h"
 #include "Common/GameSpyMiscPreferences.h"
 
 #include "GameClient/ControlBar.h"
@@ -83,6 +84,7 @@
 #include "GameLogic/FPUControl.h"
 #include "GameLogic/GameLogic.h"
 #include "GameLogic/Locomotor.h"
+#include "GameLogic/LogicProfiler.h"
 #include "GameLogic/Object.h"
 #include "GameLogic/Module/AIUpdate.h"
 #include "GameLogic/Module/BodyModule.h"
@@ -94,6 +96,7 @@
 #include "GameLogic/ScriptActions.h"
 #include "GameLogic/ScriptConditions.h"
 #include "GameLogic/ScriptEngine.h"
+#include "GameLogic/ScriptProfiler.h"
 #include "GameLogic/SidesList.h"
 #include "GameLogic/VictoryConditions.h"
 #include "GameLogic/Weapon.h"
@@ -220,6 +223,7 @@ GameLogic::GameLogic( void )
 	//Initializations missing and necessary
 	m_background = NULL;
 	m_CRC = 0;
+	m_incrementalCRCCount = 0;
 	m_isInUpdate = FALSE;
 
 	m_rankPointsToAddAtGameStart = 0;
@@ -367,10 +371,17 @@ GameLogic::~GameLogic()
 	delete TheScriptConditions;
 	TheScriptConditions = NULL;
 
+	// The script profiler names the condition and action types through the script engine.
+	delete TheScriptProfiler;
+	TheScriptProfiler = NULL;
+
 	// delete the Script Engine
 	delete TheScriptEngine;
 	TheScriptEngine = NULL;
 
+	delete TheLogicProfiler;
+	TheLogicProfiler = NULL;
+
 	// Null out TheGameLogic
 	TheGameLogic = NULL;
 }
@@ -409,11 +420,32 @@ void GameLogic::init( void )
 	TheScriptEngine->init();
 	TheScriptEngine->setName("TheScriptEngine");
 
+	if (TheGlobalData->m_logicProfileFile.isNotEmpty() && TheLogicProfiler == NULL)
+	{
+		TheLogicProfiler = NEW LogicProfiler;
+		if (!TheLogicProfiler->init(TheGlobalData->m_logicProfileFile))
+		{
+			DEBUG_CRASH(("Cannot open logic profile file '%s'", TheGlobalData->m_logicProfileFile.str()));
+			printf("Cannot open logic profile file \"%s\"\n", TheGlobalData->m_logicProfileFile.str());
+		}
+	}
+
+	if (TheGlobalData->m_scriptProfileFile.isNotEmpty() && TheScriptProfiler == NULL)
+	{
+		TheScriptProfiler = NEW ScriptProfiler;
+		if (!TheScriptProfiler->init(TheGlobalData->m_scriptProfileFile))
+		{
+			DEBUG_CRASH(("Cannot open script profile file '%s'", TheGlobalData->m_scriptProfileFile.str()));
+			printf("Cannot open script profile file \"%s\"\n", TheGlobalData->m_scriptProfileFile.str());
+		}
+	}
+
 	// create a team for the player
 	//DEBUG_ASSERTCRASH(ThePlayerList, ("null ThePlayerList"));
 	//ThePlayerList->setLocalPlayer(0);
 
 	m_CRC = 0;
+	m_incrementalCRCCount = 0;
 	m_pauseFrame = 0;
 	m_gamePaused = FALSE;
 	m_pauseSound = FALSE;
@@ -444,6 +476,12 @@ void GameLogic::init( void )
 //-------------------------------------------------------------------------------------------------
 void GameLogic::reset( void )
 {
+	// Results are reported per game.
+	if (TheLogicProfiler)
+		TheLogicProfiler->report();
+	if (TheScriptProfiler)
+		TheScriptProfiler->report();
+
 	m_thingTemplateBuildableOverrides.clear();
 	m_controlBarOverrides.clear();
 
@@ -476,6 +514,7 @@ void GameLogic::reset( void )
 	TheScriptEngine->reset();
 
 	m_CRC = 0;
+	m_incrementalCRCCount = 0;
 	for(Int i = 0; i < MAX_SLOTS; ++i)
 	{
 		m_progressComplete[i] = FALSE;
@@ -3685,8 +3724,12 @@ void GameLogic::update( void )
 	UnsignedInt now = TheGameLogic->getFrame();
 	TheGameClient->setFrame(now);
 
+	if (TheLogicProfiler)
+		TheLogicProfiler->beginFrame(now);
+
 	// update (execute) scripts
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_SCRIPT_ENGINE);
 		TheScriptEngine->UPDATE();
 	}
 
@@ -3709,6 +3752,7 @@ void GameLogic::update( void )
 	// Note - TerrainLogic update needs to happen after ScriptEngine update, but before object updates.  jba.
 	// This way changes in bridges are noted in the script engine before being cleared in TerrainLogic->update
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_TERRAIN_LOGIC);
 		TheTerrainLogic->UPDATE();
 	}
 
@@ -3757,11 +3801,13 @@ void GameLogic::update( void )
 
 	// process client commands
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_COMMANDS);
 		processCommandList( TheCommandList );
 	}
 
 #ifdef ALLOW_NONSLEEPY_UPDATES
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_NORMAL_UPDATES);
 		for (std::list<UpdateModulePtr>::const_iterator it = m_normalUpdates.begin(); it != m_normalUpdates.end(); ++it)
 		{
 			UpdateModulePtr u = *it;
@@ -3771,6 +3817,8 @@ void GameLogic::update( void )
 				USE_PERF_TIMER(GameLogic_update_normal)
 
 				m_curUpdateModule = u;
+				u->friend_getObject()->markCRCDirty();
+				const Int64 startTicks = TheLogicProfiler ? LogicProfiler::getTicks() : 0;
 
 				#ifdef DEBUG_LOGGING
 					UpdateSleepTime sleep = u->update();
@@ -3779,6 +3827,8 @@ void GameLogic::update( void )
 					u->update();
 				#endif
 
+				if (TheLogicProfiler)
+					TheLogicProfiler->addUpdateTime(u->getModuleNameKey(), LogicProfiler::getTicks() - startTicks);
 				m_curUpdateModule = NULL;
 			}
 		}
@@ -3786,6 +3836,7 @@ void GameLogic::update( void )
 #endif
 
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_SLEEPY_UPDATES);
 		while (!m_sleepyUpdates.empty())
 		{
 			UpdateModulePtr u = peekSleepyUpdate();
@@ -3812,12 +3863,16 @@ void GameLogic::update( void )
 
 				//DEBUG_LOG(("calling update %08lx (%d %d)...",update,update->friend_getNextCallFrame(),update->friend_getNextCallPhase()));
 				m_curUpdateModule = u;
+				u->friend_getObject()->markCRCDirty();
+				const Int64 startTicks = TheLogicProfiler ? LogicProfiler::getTicks() : 0;
 
 				sleepLen = u->update();
 				DEBUG_ASSERTCRASH(sleepLen > 0, ("you may not return 0 from update"));
 				if (sleepLen < 1)
 					sleepLen = UPDATE_SLEEP_NONE;
 
+				if (TheLogicProfiler)
+					TheLogicProfiler->addUpdateTime(u->getModuleNameKey(), LogicProfiler::getTicks() - startTicks);
 				m_curUpdateModule = NULL;
 
 			}
@@ -3832,16 +3887,19 @@ void GameLogic::update( void )
 
 	// update the Artificial Intelligence system
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_AI);
 		TheAI->UPDATE();
 	}
 
 	// production updates
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_BUILD_ASSISTANT);
 		TheBuildAssistant->UPDATE();
 	}
 
 	// update partition info
 	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_PARTITION_MANAGER);
 		ThePartitionManager->UPDATE();
 	}
 
@@ -3850,12 +3908,18 @@ void GameLogic::update( void )
 	//
 
 	// destroy all pending objects
-	processDestroyList();
+	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_DESTROY_LIST);
+		processDestroyList();
+	}
 
 	// reset the command list, destroying all messages
 	TheCommandList->reset();
 
-	TheWeaponStore->UPDATE();
+	{
+		LogicProfilerScope profile(LogicProfiler::SECTION_WEAPON_STORE);
+		TheWeaponStore->UPDATE();
+	}
 	TheLocomotorStore->UPDATE();
 	TheVictoryConditions->UPDATE();
 
@@ -3878,6 +3942,9 @@ void GameLogic::update( void )
 	if (!m_startNewGame)
 	{
 		m_frame++;
+
+		if (m_frame == TheGlobalData->m_xferBenchmarkFrame)
+			benchmarkXfer();
 	}
 }
 
@@ -4076,6 +4143,121 @@ void GameLogic::destroyObject( Object *obj )
 
 }  // end destroyObject
 
+// ------------------------------------------------------------------------------------------------
+/** TheSuperHackers @performance Add the CRC of every object to the game CRC, but only calculate
+ * it again for the objects that were marked dirty since the last CRC interval. All objects are
+ * calculated again every INCREMENTAL_CRC_REFRESH_INTERVAL intervals, so that a mismatch in state
+ * that does not mark the object dirty is still found eventually. */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::xferObjectCRCs( XferCRC *xferCRC )
+{
+	enum { INCREMENTAL_CRC_REFRESH_INTERVAL = 16 };
+
+	// Only the CRC of the logic update consumes the dirty flags, so that CRCs requested from
+	// elsewhere do not make the cached object CRCs differ between the players.
+	const Bool isLogicCRC = isInGameLogicUpdate();
+	Bool recalcAll = FALSE;
+	if (isLogicCRC)
+	{
+		recalcAll = (m_incrementalCRCCount % INCREMENTAL_CRC_REFRESH_INTERVAL) == 0;
+		++m_incrementalCRCCount;
+	}
+
+	const AsciiString objectCRCName("objectCRC");
+	XferCRC objectCRC;
+	for( Object *obj = m_objList; obj; obj=obj->getNextObject() )
+	{
+		UnsignedInt crc;
+		if (recalcAll || obj->isCRCDirty())
+		{
+			objectCRC.open(objectCRCName);
+			objectCRC.xferSnapshot( obj );
+			objectCRC.close();
+			crc = objectCRC.getCRC();
+
+			if (isLogicCRC)
+				obj->setCachedCRC(crc);
+		}
+		else
+		{
+			crc = obj->getCachedCRC();
+		}
+
+		xferCRC->xferUnsignedInt( &crc );
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Save the game state and calculate its CRC a number of times and print the timings */
+// ------------------------------------------------------------------------------------------------
+void GameLogic::benchmarkXfer( void )
+{
+	enum { BENCHMARK_ITERATIONS = 20 };
+
+	// This is not part of the logic update, so that the CRCs do not change any CRC state of the update.
+	LatchRestore<Bool> latch(m_isInUpdate, FALSE);
+
+	AsciiString filename;
+	filename.format("%sXferBenchmark.sav", TheGlobalData->getPath_UserData().str());
+
+	Int objectCount = 0;
+	for( Object *obj = m_objList; obj; obj=obj->getNextObject() )
+		++objectCount;
+
+	Int64 ticksPerSecond;
+	Int64 startTicks;
+	Int64 saveTicks;
+	Int64 crcTicks;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&ticksPerSecond);
+
+	// Note that we use printf here because this is run from cmd.
+	try
+	{
+		QueryPerformanceCounter((LARGE_INTEGER *)&startTicks);
+		for (Int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+		{
+			XferSave xferSave;
+			xferSave.open(filename);
+			TheGameState->friend_xferSaveDataForCRC(&xferSave, SNAPSHOT_DEEPCRC_LOGICONLY);
+			xferSave.flush();
+			xferSave.close();
+		}
+		QueryPerformanceCounter((LARGE_INTEGER *)&saveTicks);
+		saveTicks -= startTicks;
+	}
+	catch (...)
+	{
+		printf("Xfer benchmark cannot save to \"%s\"\n", filename.str());
+		fflush(stdout);
+		return;
+	}
+
+	UnsignedInt crc = 0;
+	QueryPerformanceCounter((LARGE_INTEGER *)&startTicks);
+	for (Int i = 0; i < BENCHMARK_ITERATIONS; ++i)
+	{
+		crc = getCRC( CRC_RECALC );
+	}
+	QueryPerformanceCounter((LARGE_INTEGER *)&crcTicks);
+	crcTicks -= startTicks;
+
+	long fileSize = 0;
+	FILE *fp = fopen(filename.str(), "rb");
+	if (fp != NULL)
+	{
+		fseek(fp, 0, SEEK_END);
+		fileSize = ftell(fp);
+		fclose(fp);
+	}
+	remove(filename.str());
+
+	const double millisecondsPerTick = 1000.0 / (double)ticksPerSecond / BENCHMARK_ITERATIONS;
+	printf("Xfer benchmark at frame %u with %d objects:\n", m_frame, objectCount);
+	printf("   Save %10.3f ms %10ld bytes\n", (double)saveTicks * millisecondsPerTick, fileSize);
+	printf("   CRC  %10.3f ms 0x%8.8X\n", (double)crcTicks * millisecondsPerTick, crc);
+	fflush(stdout);
+}
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 Bool inCRCGen = FALSE;
@@ -4129,9 +4311,18 @@ UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 
 	marker = "MARKER:Objects";
 	xferCRC->xferAsciiString(&marker);
-	for( obj = m_objList; obj; obj=obj->getNextObject() )
+#if !RETAIL_COMPATIBLE_CRC
+	if (TheGlobalData->m_incrementalObjectCRC && xferCRC->getXferMode() == XFER_CRC)
+	{
+		xferObjectCRCs( xferCRC );
+	}
+	else
+#endif
 	{
-		xferCRC->xferSnapshot( obj );
+		for( obj = m_objList; obj; obj=obj->getNextObject() )
+		{
+			xferCRC->xferSnapshot( obj );
+		}
 	}
 	UnsignedInt seed = GetGameLogicRandomSeedCRC();
 	if (isInGameLogicUpdate())
@@ -0,0 +1,195 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 TheSuperHackers
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// LogicProfiler.cpp
+// Per frame timings of the game logic subsystems and update modules
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file in the GameEngine
+
+#include "GameLogic/LogicProfiler.h"
+
+LogicProfiler *TheLogicProfiler = NULL;
+
+static const char *const SectionNames[LogicProfiler::SECTION_COUNT] =
+{
+	"ScriptEngine",
+	"TerrainLogic",
+	"Commands",
+	"NormalUpdates",
+	"SleepyUpdates",
+	"AI",
+	"BuildAssistant",
+	"PartitionManager",
+	"DestroyList",
+	"WeaponStore",
+};
+
+//-------------------------------------------------------------------------------------------------
+LogicProfiler::LogicProfiler() :
+	m_file(NULL),
+	m_isFrameOpen(FALSE),
+	m_frame(0)
+{
+	for (Int i = 0; i < SECTION_COUNT; ++i)
+	{
+		m_sectionTicks[i] = 0;
+		m_sectionCalls[i] = 0;
+		m_totalSectionTicks[i] = 0;
+	}
+
+	Int64 ticksPerSecond;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&ticksPerSecond);
+	m_microsecondsPerTick = 1000000.0 / (double)ticksPerSecond;
+}
+
+//-------------------------------------------------------------------------------------------------
+LogicProfiler::~LogicProfiler()
+{
+	report();
+
+	if (m_file != NULL)
+	{
+		fclose(m_file);
+		m_file = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool LogicProfiler::init( const AsciiString& filename )
+{
+	m_file = fopen(filename.str(), "w");
+	if (m_file == NULL)
+		return FALSE;
+
+	fprintf(m_file, "frame,kind,name,calls,microseconds\n");
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+void LogicProfiler::beginFrame( UnsignedInt frame )
+{
+	if (m_isFrameOpen)
+		writeFrame();
+
+	m_frame = frame;
+	m_isFrameOpen = TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+void LogicProfiler::addUpdateTime( NameKeyType moduleNameKey, Int64 ticks )
+{
+	if ((size_t)moduleNameKey >= m_updates.size())
+	{
+		m_updates.resize(moduleNameKey + 1);
+		m_totalUpdates.resize(moduleNameKey + 1);
+	}
+
+	Timing& timing = m_updates[moduleNameKey];
+	if (timing.calls == 0)
+		m_updatesThisFrame.push_back(moduleNameKey);
+
+	timing.ticks += ticks;
+	++timing.calls;
+}
+
+//-------------------------------------------------------------------------------------------------
+void LogicProfiler::writeFrame( void )
+{
+	for (Int i = 0; i < SECTION_COUNT; ++i)
+	{
+		if (m_sectionCalls[i] != 0 && m_file != NULL)
+		{
+			fprintf(m_file, "%u,section,%s,%d,%.1f\n",
+				m_frame, SectionNames[i], m_sectionCalls[i], ticksToMicroseconds(m_sectionTicks[i]));
+		}
+
+		m_totalSectionTicks[i] += m_sectionTicks[i];
+		m_sectionTicks[i] = 0;
+		m_sectionCalls[i] = 0;
+	}
+
+	for (std::vector<NameKeyType>::const_iterator it = m_updatesThisFrame.begin(); it != m_updatesThisFrame.end(); ++it)
+	{
+		Timing& timing = m_updates[*it];
+		if (m_file != NULL)
+		{
+			fprintf(m_file, "%u,update,%s,%d,%.1f\n",
+				m_frame, KEYNAME(*it).str(), timing.calls, ticksToMicroseconds(timing.ticks));
+		}
+
+		Timing& total = m_totalUpdates[*it];
+		total.ticks += timing.ticks;
+		total.calls += timing.calls;
+		timing = Timing();
+	}
+	m_updatesThisFrame.clear();
+
+	m_isFrameOpen = FALSE;
+}
+
+//-------------------------------------------------------------------------------------------------
+static bool compareTotalTicks( const std::pair<Int64, NameKeyType>& a, const std::pair<Int64, NameKeyType>& b )
+{
+	return a.first > b.first;
+}
+
+//-------------------------------------------------------------------------------------------------
+void LogicProfiler::report( void )
+{
+	if (m_isFrameOpen)
+		writeFrame();
+
+	if (m_file != NULL)
+		fflush(m_file);
+
+	Int i;
+	size_t j;
+
+	std::vector< std::pair<Int64, NameKeyType> > updates;
+	for (j = 0; j < m_totalUpdates.size(); ++j)
+	{
+		if (m_totalUpdates[j].calls != 0)
+			updates.push_back(std::make_pair(m_totalUpdates[j].ticks, (NameKeyType)j));
+	}
+
+	Bool hasResults = !updates.empty();
+	for (i = 0; i < SECTION_COUNT; ++i)
+		hasResults |= m_totalSectionTicks[i] != 0;
+	if (!hasResults)
+		return;
+
+	// Note that we use printf here because this is run from cmd.
+	printf("Logic profile up to frame %u:\n", m_frame);
+	for (i = 0; i < SECTION_COUNT; ++i)
+	{
+		printf("   %-20s %10.1f ms\n", SectionNames[i], ticksToMicroseconds(m_totalSectionTicks[i]) / 1000.0);
+		m_totalSectionTicks[i] = 0;
+	}
+
+	const size_t MAX_REPORTED_UPDATES = 20;
+	std::sort(updates.begin(), updates.end(), compareTotalTicks);
+	for (j = 0; j < updates.size() && j < MAX_REPORTED_UPDATES; ++j)
+	{
+		const Timing& total = m_totalUpdates[updates[j].second];
+		printf("   %-40s %10.1f ms %10d calls\n",
+			KEYNAME(updates[j].second).str(), ticksToMicroseconds(total.ticks) / 1000.0, total.calls);
+	}
+	fflush(stdout);
+
+	m_totalUpdates.assign(m_totalUpdates.size(), Timing());
+}